@@ -153,7 +153,7 @@ RESOURCES += Resources.qrc
 
 win32:CONFIG(release, debug|release): LIBS += -LC:/Users/crush/workspace/OpenSceneGraph-3.0.1/lib/ -L$$PWD/external/meshLib/lib -L$$PWD/external/treLib/lib -L$$PWD/external/lua/include -L$$PWD/external/swgOSG/lib -lswgRepository -lmeshLib -ltreLib -losg -losgViewer -losgText -losgDB -losgGA -losgAnimation -losgQt -lOpenThreads
 else:win32:CONFIG(debug, debug|release): LIBS += -LC:/Users/crush/workspace/OpenSceneGraph-3.0.1/lib/ -L$$PWD/external/meshLib/lib -L$$PWD/external/treLib/lib -L$$PWD/external/swgOSG/lib -L$$PWD/external/lua/src -lswgRepositoryd -lmeshLibd -ltreLibd  -losgd -losgViewerd -losgTextd -losgDBd -losgGAd -losgAnimationd -losgQtd -losgQtd -lOpenThreadsd
-else:unix:!symbian: LIBS += -L$$PWD/../../osg_vs9/OpenSceneGraph-3.0.1-build/lib/ -L$$PWD/external/meshLib/lib -L$$PWD/external/treLib/lib -L$$PWD/external/swgOSG/lib  -lswgRepository -lswg -lswgMsh -losg -losgViewer -ltreLib  -losgText -losgDB -losgGA -losgAnimation -losgQt
+else:unix:!symbian: LIBS += -L$$PWD/../../osg_vs9/OpenSceneGraph-3.0.1-build/lib/ -L$$PWD/external/meshLib/lib -L$$PWD/external/treLib/lib -L$$PWD/external/swgOSG/lib  -lswgRepository -lswg -lswgMsh -losg -losgViewer -ltreLib  -losgText -losgDB -losgGA -losgAnimation -losgQt -lboost_thread -lboost_system
 
 INCLUDEPATH += C:/Users/crush/workspace/OpenSceneGraph-3.0.1/include $$PWD/external/treLib/include $$PWD/external/lua/include $$PWD/external/meshLib/include $$PWD/external/swgOSG/include "C:/Program Files/boost/boost_1_48_0"
 DEPENDPATH += C:/Users/crush/workspace/OpenSceneGraph-3.0.1/include $$PWD/external/treLib/include $$PWD/external/lua/include $$PWD/external/meshLib/include $$PWD/external/swgOSG/include "C:/Program Files/boost/boost_1_48_0"
@@ -32,6 +32,7 @@
 #include <meshLib/box.hpp>
 #include <meshLib/vector3.hpp>
 #include <meshLib/matrix3.hpp>
+#include <meshLib/stringTable.hpp>
 
 #ifndef BASE_HPP
 #define BASE_HPP
@@ -68,6 +69,13 @@ namespace ml
     static unsigned int read(  std::istream &file, std::string &data );
     static unsigned int write( std::ostream &file, const std::string &data );
 
+    /// Read a NUL terminated string into table, data points to the
+    /// interned copy. Allocates only for strings new to the table,
+    /// at most 254 characters are read like the std::string overload.
+    static unsigned int read(  std::istream &file,
+			       stringTable &table,
+			       const std::string *&data );
+
     static void peekHeader( std::istream &file,
 			    std::string &form,
 			    unsigned int &size,
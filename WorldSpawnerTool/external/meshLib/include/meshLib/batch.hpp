@@ -0,0 +1,130 @@
+/** -*-c++-*-
+ *  \class  batch
+ *  \file   batch.hpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <meshLib/base.hpp>
+
+#include <istream>
+#include <ostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+namespace ml
+{
+  /// Provides the raw IFF data for a path, eg. from a treArchive.
+  class streamSource
+  {
+  public:
+    virtual ~streamSource() {};
+
+    /// Returns a new stream owned by the caller or NULL if not found.
+    /// Must be safe to call from several threads at once.
+    virtual std::istream *getFileStream( const std::string &path ) = 0;
+  };
+
+  /// Parses many IFF files on a pool of threads.
+  class batch
+  {
+  public:
+    struct result
+    {
+      result() : size( 0 ), seconds( 0.0 ) {}
+
+      bool ok() const
+      {
+	return error.empty();
+      }
+
+      /// Returns the parsed object if it is of type T, else NULL.
+      template< class T > boost::shared_ptr<T> get() const
+      {
+	return boost::dynamic_pointer_cast<T>( object );
+      }
+
+      std::string path;
+      std::string type;
+      boost::shared_ptr<base> object;
+      std::string error;
+      unsigned int size;
+      double seconds;
+    };
+
+    struct typeStats
+    {
+      typeStats() : count( 0 ), failures( 0 ), bytes( 0 ), seconds( 0.0 ) {}
+
+      unsigned int count;
+      unsigned int failures;
+      unsigned long long bytes;
+      double seconds;
+    };
+
+    /// numThreads of 0 uses one thread per hardware core.
+    batch( streamSource &source, unsigned int numThreads = 0 );
+    ~batch();
+
+    /// Fetches and parses every path, results are in the same order.
+    void parse( const std::vector<std::string> &paths,
+		std::vector<result> &results );
+
+    /// Parse a single stream of the given IFF type (see base::getType).
+    static boost::shared_ptr<base> parseStream( std::istream &file,
+						const std::string &type );
+
+    const std::map<std::string, typeStats> &getTypeStats() const
+    {
+      return stats;
+    }
+
+    void clearTypeStats();
+    void printTypeStats( std::ostream &out ) const;
+
+    unsigned int getNumThreads() const
+    {
+      return numThreads;
+    }
+
+  protected:
+    void worker( const std::vector<std::string> *paths,
+		 std::vector<result> *results );
+    void parseOne( const std::string &path, result &res );
+
+    streamSource &source;
+    unsigned int numThreads;
+
+    std::map<std::string, typeStats> stats;
+    unsigned int nextPath;
+    boost::mutex mutex;
+
+  private:
+  };
+}
+
+#endif
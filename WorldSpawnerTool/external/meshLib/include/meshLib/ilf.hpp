@@ -26,11 +26,14 @@
 #include <meshLib/model.hpp>
 #include <meshLib/matrix3.hpp>
 #include <meshLib/vector3.hpp>
+#include <meshLib/stringTable.hpp>
 
 #include <fstream>
 #include <vector>
 #include <string>
 
+#include <boost/shared_ptr.hpp>
+
 #ifndef ILF_HPP
 #define ILF_HPP
 
@@ -65,8 +68,10 @@ namespace ml
     unsigned int readNODE( std::istream &file );
 	
 
-    std::vector<std::string> nodeFilename;
-    std::vector<std::string> nodeZone;
+    // Interned in names, which copies share.
+    std::vector<const std::string *> nodeFilename;
+    std::vector<const std::string *> nodeZone;
+    boost::shared_ptr<stringTable> names;
     std::vector<matrix3> nodeMatrix;
     std::vector<vector3> nodeVector;
   private:
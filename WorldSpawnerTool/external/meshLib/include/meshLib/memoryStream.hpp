@@ -0,0 +1,65 @@
+/** -*-c++-*-
+ *  \class  memoryStream
+ *  \file   memoryStream.hpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <istream>
+#include <streambuf>
+
+#ifndef MEMORYSTREAM_HPP
+#define MEMORYSTREAM_HPP
+
+namespace ml
+{
+  /// Read only stream buffer over memory owned by the caller.
+  class memoryStreamBuf : public std::streambuf
+  {
+  public:
+    memoryStreamBuf( const char *data, unsigned int size );
+
+  protected:
+    pos_type seekoff( off_type offset,
+		      std::ios_base::seekdir dir,
+		      std::ios_base::openmode which );
+    pos_type seekpos( pos_type position,
+		      std::ios_base::openmode which );
+
+  private:
+  };
+
+  /// std::istream reading straight from a memory buffer without
+  /// copying it, eg. a mapped file or a record pulled from a TRE.
+  class memoryStream : public std::istream
+  {
+  public:
+    memoryStream( const char *data, unsigned int size );
+    ~memoryStream();
+
+  protected:
+    memoryStreamBuf buffer;
+
+  private:
+  };
+}
+
+#endif
@@ -0,0 +1,186 @@
+/** -*-c++-*-
+ *  \class  meshCache
+ *  \file   meshCache.hpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <meshLib/msh.hpp>
+#include <meshLib/skmg.hpp>
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#ifndef MESHCACHE_HPP
+#define MESHCACHE_HPP
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
+namespace ml
+{
+  /// On-disk cache of flattened mesh geometry.
+  ///
+  /// Each cached model is one file holding ready to draw vertex,
+  /// color, texture coordinate and index arrays plus the shader names.
+  /// Files are memory mapped on lookup and the arrays are used in
+  /// place, so reopening a model needs no IFF parsing at all.
+  /// Entries are keyed by archive path and validated against the MD5
+  /// of the source file, a changed source simply misses.
+  class meshCache
+  {
+  public:
+    enum
+      {
+	VERSION = 1
+      };
+
+    /// View of one drawable surface inside a mapped cache file.
+    class surface
+    {
+    public:
+      surface();
+
+      const char *getShader() const { return shader; }
+      unsigned int getNumVertices() const { return numVertices; }
+
+      /// x, y, z per vertex.
+      const float *getPositions() const { return positions; }
+
+      /// x, y, z per vertex.
+      const float *getNormals() const { return normals; }
+
+      /// r, g, b, a per vertex, 0.0 to 1.0.
+      const float *getColors() const { return colors; }
+
+      /// Number of texture coordinate sets, at most MAX_TEXTURES.
+      unsigned int getNumTexCoordSets() const { return numTexCoordSets; }
+
+      /// u, v per vertex.
+      const float *getTexCoords( unsigned int set ) const
+      {
+	return texCoords[set];
+      }
+
+      /// Number of triangle lists.
+      unsigned int getNumGroups() const { return groupSize.size(); }
+      unsigned int getNumIndices( unsigned int group ) const
+      {
+	return groupSize[group];
+      }
+      const unsigned int *getIndices( unsigned int group ) const
+      {
+	return groupIndices[group];
+      }
+
+    protected:
+      friend class meshCache;
+
+      const char *shader;
+      unsigned int numVertices;
+      const float *positions;
+      const float *normals;
+      const float *colors;
+      unsigned int numTexCoordSets;
+      const float *texCoords[MAX_TEXTURES];
+      std::vector<unsigned int> groupSize;
+      std::vector<const unsigned int *> groupIndices;
+    };
+
+    /// A mapped cache file, the mapping lives as long as the entry.
+    class entry
+    {
+    public:
+      unsigned int getNumSurfaces() const { return surfaces.size(); }
+      const surface &getSurface( unsigned int index ) const
+      {
+	return surfaces[index];
+      }
+
+    protected:
+      friend class meshCache;
+
+      boost::shared_ptr<boost::interprocess::mapped_region> region;
+      std::vector<surface> surfaces;
+    };
+
+    /// Cache files are kept in directory, which must exist.
+    meshCache( const std::string &directory );
+    ~meshCache();
+
+    /// Map the cached copy of path. md5sum is the 16 byte sum of the
+    /// source file. Returns NULL on a miss or a stale entry.
+    boost::shared_ptr<entry> find( const std::string &path,
+				   const std::vector<unsigned char> &md5sum );
+
+    /// Flatten a parsed model, write it to the cache and map it.
+    boost::shared_ptr<entry> store( const std::string &path,
+				    const std::vector<unsigned char> &md5sum,
+				    msh &mesh );
+    boost::shared_ptr<entry> store( const std::string &path,
+				    const std::vector<unsigned char> &md5sum,
+				    const skmg &mesh );
+
+    /// Name of the cache file for path, relative to the cache directory.
+    static std::string getCacheFilename( const std::string &path );
+
+    unsigned int getNumHits() const { return numHits; }
+    unsigned int getNumMisses() const { return numMisses; }
+
+  protected:
+    /// Surface data before it is written out.
+    struct flatSurface
+    {
+      std::string shader;
+      std::vector<float> positions;
+      std::vector<float> normals;
+      std::vector<float> colors;
+      std::vector< std::vector<float> > texCoords;
+      std::vector< std::vector<unsigned int> > groups;
+    };
+
+    bool write( const std::string &filename,
+		const std::string &path,
+		const std::vector<unsigned char> &md5sum,
+		const std::vector<flatSurface> &surfaces );
+
+    boost::shared_ptr<entry> map( const std::string &filename,
+				  const std::string &path,
+				  const std::vector<unsigned char> &md5sum );
+
+    std::string directory;
+
+    unsigned int numHits;
+    unsigned int numMisses;
+    boost::mutex mutex;
+
+  private:
+  };
+}
+
+#endif
@@ -0,0 +1,69 @@
+/** -*-c++-*-
+ *  \class  stringTable
+ *  \file   stringTable.hpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <set>
+#include <string>
+
+#ifndef STRINGTABLE_HPP
+#define STRINGTABLE_HPP
+
+namespace ml
+{
+  /// Keeps one copy of every distinct string read during a parse.
+  ///
+  /// Readers hand out references to the interned strings instead of
+  /// copies, so a name repeated across thousands of records costs a
+  /// single allocation. References stay valid until clear() or the
+  /// table is destroyed. Not thread safe, use one table per parse.
+  class stringTable
+  {
+  public:
+    stringTable();
+    ~stringTable();
+
+    const std::string &intern( const char *data, unsigned int size );
+    const std::string &intern( const std::string &data );
+
+    unsigned int size() const
+    {
+      return strings.size();
+    }
+
+    void clear();
+
+    /// Shared empty string for unset references.
+    static const std::string &empty();
+
+  protected:
+    std::set<std::string> strings;
+
+    // Lookup key, reused so strings already in the table do not allocate.
+    std::string key;
+
+  private:
+  };
+}
+
+#endif
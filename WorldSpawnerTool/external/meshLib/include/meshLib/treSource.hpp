@@ -0,0 +1,54 @@
+/** -*-c++-*-
+ *  \class  treSource
+ *  \file   treSource.hpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <meshLib/batch.hpp>
+
+#include <treLib/treArchive.hpp>
+
+#ifndef TRESOURCE_HPP
+#define TRESOURCE_HPP
+
+namespace ml
+{
+  /// streamSource reading the files of a treArchive. Header only, so
+  /// meshLib itself does not link against treLib.
+  class treSource : public streamSource
+  {
+  public:
+    treSource( treArchive &tre ) : archive( tre ) {}
+
+    /// treArchive::getFileStream guards the TRE reads with its mutex.
+    std::istream *getFileStream( const std::string &path )
+    {
+      return archive.getFileStream( path );
+    }
+
+  protected:
+    treArchive &archive;
+
+  private:
+  };
+}
+
+#endif
@@ -76,13 +76,18 @@ namespace ml
       return globalWaterTableHeight;
     }
 
+    /// Runs every layer over a numRows by numCols heightfield. The rows
+    /// are split in bands applied on numThreads threads, 0 for one per
+    /// hardware core. Layers are only read, so this is safe while nothing
+    /// else modifies them.
     bool applyLayers( const float &originX,
 		      const float &originY,
 		      const float &spacingX,
 		      const float &spacingY,
 		      const unsigned int &numRows,
 		      const unsigned int &numCols,
-		      float *data) const;
+		      float *data,
+		      unsigned int numThreads = 0 ) const;
 
   protected:
     unsigned int readTGEN( std::istream &file, const std::string & );
@@ -146,7 +151,7 @@ namespace ml
     unsigned int mapWidth;
 
     std::map<unsigned int, sfam> sfamMap;
-    std::list<boost::shared_ptr<trnLayer> > layerList;
+    std::vector<boost::shared_ptr<trnLayer> > layerList;
 
   };
 }
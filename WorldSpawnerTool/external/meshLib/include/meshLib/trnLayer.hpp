@@ -25,7 +25,7 @@
 #include <meshLib/base.hpp>
 #include <boost/shared_ptr.hpp>
 #include <string>
-#include <list>
+#include <vector>
 
 #include <meshLib/trnBoundary.hpp>
 #include <meshLib/trnAffector.hpp>
@@ -48,6 +48,19 @@ namespace ml
 			const unsigned int &numRows,
 			const unsigned int &numCols,
 			float *data) const;
+
+    /// Applies this layer and its sub layers to rows firstRow up to, not
+    /// including, lastRow of a heightfield laid out like apply() expects.
+    /// Only touches those rows, so disjoint bands may run in parallel.
+    void applyRows( const float &originX,
+		    const float &originY,
+		    const float &spacingX,
+		    const float &spacingY,
+		    const unsigned int &firstRow,
+		    const unsigned int &lastRow,
+		    const unsigned int &numCols,
+		    float *data) const;
+
     unsigned int read( std::istream &file,
 		       const std::string &debugString );
 
@@ -59,9 +72,9 @@ namespace ml
     unsigned int u1;
     std::string name;
 
-    std::list< boost::shared_ptr<trnAffector> > affectorList;
-    std::list< boost::shared_ptr<trnLayer> > layerList;
-    std::list< boost::shared_ptr<trnBoundary> > boundaryList;
+    std::vector< boost::shared_ptr<trnAffector> > affectorList;
+    std::vector< boost::shared_ptr<trnLayer> > layerList;
+    std::vector< boost::shared_ptr<trnBoundary> > boundaryList;
   };
 }
 #endif
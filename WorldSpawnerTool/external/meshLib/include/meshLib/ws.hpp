@@ -24,12 +24,15 @@
 */
 
 #include <meshLib/base.hpp>
+#include <meshLib/stringTable.hpp>
 
 #include <fstream>
 #include <vector>
 #include <list>
 #include <string>
 
+#include <boost/shared_ptr.hpp>
+
 #ifndef WS_HPP
 #define WS_HPP
 
@@ -159,7 +162,10 @@ namespace ml
     unsigned int writeOTNL( std::ofstream &outfile );
 	
     std::vector< wsNode > nodes;
-    std::vector< std::string > objectNames;
+    std::vector< const std::string * > objectNames;
+
+    // Shared by copies so node filenames stay valid.
+    boost::shared_ptr<stringTable> names;
   private:
     std::vector< wsNode >::iterator currentNode;
     unsigned int maxObjectIndex;
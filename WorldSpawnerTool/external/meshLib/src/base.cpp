@@ -26,6 +26,7 @@
 #include <meshLib/base.hpp>
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 
 using namespace ml;
 
@@ -335,6 +336,16 @@ unsigned int base::read( std::istream &file, std::string &data )
   return( data.size() + 1 );
 }
 
+unsigned int base::read( std::istream &file,
+			 stringTable &table,
+			 const std::string *&data )
+{
+  char temp[255];
+  file.getline( temp, 255, 0 );
+  data = &table.intern( temp, static_cast<unsigned int>( strlen( temp ) ) );
+  return( data->size() + 1 );
+}
+
 unsigned int base::write( std::ostream &file, const std::string &data )
 {
   file.write( data.c_str(), data.size()+1 );
@@ -0,0 +1,451 @@
+/** -*-c++-*-
+ *  \class  batch
+ *  \file   batch.cpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <meshLib/batch.hpp>
+
+#include <meshLib/apt.hpp>
+#include <meshLib/cach.hpp>
+#include <meshLib/cclt.hpp>
+#include <meshLib/ckat.hpp>
+#include <meshLib/cldf.hpp>
+#include <meshLib/cmp.hpp>
+#include <meshLib/cshd.hpp>
+#include <meshLib/cstb.hpp>
+#include <meshLib/dtii.hpp>
+#include <meshLib/eft.hpp>
+#include <meshLib/flor.hpp>
+#include <meshLib/foot.hpp>
+#include <meshLib/ilf.hpp>
+#include <meshLib/lod.hpp>
+#include <meshLib/mlod.hpp>
+#include <meshLib/msh.hpp>
+#include <meshLib/peft.hpp>
+#include <meshLib/prto.hpp>
+#include <meshLib/sbot.hpp>
+#include <meshLib/scot.hpp>
+#include <meshLib/sd2d.hpp>
+#include <meshLib/sd3d.hpp>
+#include <meshLib/sht.hpp>
+#include <meshLib/sktm.hpp>
+#include <meshLib/skmg.hpp>
+#include <meshLib/slod.hpp>
+#include <meshLib/smat.hpp>
+#include <meshLib/spam.hpp>
+#include <meshLib/stat.hpp>
+#include <meshLib/ster.hpp>
+#include <meshLib/stot.hpp>
+#include <meshLib/swts.hpp>
+#include <meshLib/trn.hpp>
+#include <meshLib/ws.hpp>
+
+#include <iomanip>
+#include <exception>
+
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+using namespace ml;
+
+batch::batch( streamSource &src, unsigned int threads )
+  : source( src ), numThreads( threads ), nextPath( 0 )
+{
+  if( 0 == numThreads )
+    {
+      numThreads = boost::thread::hardware_concurrency();
+    }
+
+  if( 0 == numThreads )
+    {
+      numThreads = 1;
+    }
+}
+
+batch::~batch()
+{
+}
+
+void batch::clearTypeStats()
+{
+  boost::lock_guard<boost::mutex> lock( mutex );
+  stats.clear();
+}
+
+void batch::parse( const std::vector<std::string> &paths,
+		   std::vector<result> &results )
+{
+  results.clear();
+  results.resize( paths.size() );
+
+  nextPath = 0;
+
+  unsigned int threads = numThreads;
+  if( threads > paths.size() )
+    {
+      threads = paths.size();
+    }
+
+  // Small batches are not worth the thread start up.
+  if( threads <= 1 )
+    {
+      worker( &paths, &results );
+      return;
+    }
+
+  boost::thread_group pool;
+  for( unsigned int i = 0; i < threads; ++i )
+    {
+      pool.create_thread( boost::bind( &batch::worker, this,
+				       &paths, &results ) );
+    }
+  pool.join_all();
+}
+
+void batch::worker( const std::vector<std::string> *paths,
+		    std::vector<result> *results )
+{
+  while( true )
+    {
+      unsigned int index;
+      {
+	boost::lock_guard<boost::mutex> lock( mutex );
+	if( nextPath >= paths->size() )
+	  {
+	    return;
+	  }
+	index = nextPath++;
+      }
+
+      result &res = (*results)[index];
+      parseOne( (*paths)[index], res );
+
+      boost::lock_guard<boost::mutex> lock( mutex );
+      typeStats &typeStat = stats[res.type];
+      ++typeStat.count;
+      typeStat.bytes += res.size;
+      typeStat.seconds += res.seconds;
+      if( !res.ok() )
+	{
+	  ++typeStat.failures;
+	}
+    }
+}
+
+void batch::parseOne( const std::string &path, result &res )
+{
+  res.path = path;
+
+  boost::scoped_ptr<std::istream> file( source.getFileStream( path ) );
+  if( NULL == file.get() )
+    {
+      res.error = "Unable to find file";
+      return;
+    }
+
+  file->seekg( 0, std::ios_base::end );
+  res.size = file->tellg();
+  file->seekg( 0, std::ios_base::beg );
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  try
+    {
+      res.type = base::getType( *file );
+      file->seekg( 0, std::ios_base::beg );
+
+      res.object = parseStream( *file, res.type );
+      if( NULL == res.object.get() )
+	{
+	  res.error = "Unknown type: " + res.type;
+	}
+    }
+  catch( std::exception &e )
+    {
+      res.object.reset();
+      res.error = std::string( "Parse failed: " ) + e.what();
+    }
+  catch( ... )
+    {
+      res.object.reset();
+      res.error = "Parse failed: unknown exception";
+    }
+
+  res.seconds = ( boost::posix_time::microsec_clock::universal_time()
+		  - start ).total_microseconds() / 1000000.0;
+}
+
+boost::shared_ptr<base> batch::parseStream( std::istream &file,
+					     const std::string &type )
+{
+  if( "APT " == type )
+    {
+      boost::shared_ptr<apt> object( new apt );
+      object->readAPT( file );
+      return object;
+    }
+  else if( "CACH" == type )
+    {
+      boost::shared_ptr<cach> object( new cach );
+      object->readCACH( file );
+      return object;
+    }
+  else if( "CCLT" == type )
+    {
+      boost::shared_ptr<cclt> object( new cclt );
+      object->readCCLT( file );
+      return object;
+    }
+  else if( "CKAT" == type )
+    {
+      boost::shared_ptr<ckat> object( new ckat );
+      object->readCKAT( file );
+      return object;
+    }
+  else if( "CLDF" == type )
+    {
+      boost::shared_ptr<cldf> object( new cldf );
+      object->readCLDF( file );
+      return object;
+    }
+  else if( "CMPA" == type )
+    {
+      boost::shared_ptr<cmp> object( new cmp );
+      object->readCMP( file );
+      return object;
+    }
+  else if( "CSHD" == type )
+    {
+      boost::shared_ptr<cshd> object( new cshd );
+      object->readCSHD( file );
+      return object;
+    }
+  else if( "CSTB" == type )
+    {
+      boost::shared_ptr<cstb> object( new cstb );
+      object->readCSTB( file );
+      return object;
+    }
+  else if( "DTII" == type )
+    {
+      boost::shared_ptr<dtii> object( new dtii );
+      object->readDTII( file );
+      return object;
+    }
+  else if( "DTLA" == type )
+    {
+      boost::shared_ptr<lod> object( new lod );
+      object->readLOD( file );
+      return object;
+    }
+  else if( "EFCT" == type )
+    {
+      boost::shared_ptr<eft> object( new eft );
+      object->readEFT( file );
+      return object;
+    }
+  else if( "FLOR" == type )
+    {
+      boost::shared_ptr<flor> object( new flor );
+      object->readFLOR( file );
+      return object;
+    }
+  else if( "FOOT" == type )
+    {
+      boost::shared_ptr<foot> object( new foot );
+      object->readFOOT( file );
+      return object;
+    }
+  else if( "INLY" == type )
+    {
+      boost::shared_ptr<ilf> object( new ilf );
+      object->readILF( file );
+      return object;
+    }
+  else if( "MESH" == type )
+    {
+      boost::shared_ptr<msh> object( new msh );
+      object->readMSH( file );
+      return object;
+    }
+  else if( "MLOD" == type )
+    {
+      boost::shared_ptr<mlod> object( new mlod );
+      object->readMLOD( file );
+      return object;
+    }
+  else if( "PEFT" == type )
+    {
+      boost::shared_ptr<peft> object( new peft );
+      object->readPEFT( file );
+      return object;
+    }
+  else if( "PRTO" == type )
+    {
+      boost::shared_ptr<prto> object( new prto );
+      object->readPRTO( file );
+      return object;
+    }
+  else if( "PTAT" == type )
+    {
+      boost::shared_ptr<trn> object( new trn );
+      object->readTRN( file );
+      return object;
+    }
+  else if( "SBOT" == type )
+    {
+      boost::shared_ptr<sbot> object( new sbot );
+      object->readSBOT( file );
+      return object;
+    }
+  else if( "SCOT" == type )
+    {
+      boost::shared_ptr<scot> object( new scot );
+      object->readSCOT( file );
+      return object;
+    }
+  else if( "SD2D" == type )
+    {
+      boost::shared_ptr<sd2d> object( new sd2d );
+      object->readSD2D( file );
+      return object;
+    }
+  else if( "SD3D" == type )
+    {
+      boost::shared_ptr<sd3d> object( new sd3d );
+      object->readSD3D( file );
+      return object;
+    }
+  else if( "SKMG" == type )
+    {
+      boost::shared_ptr<skmg> object( new skmg );
+      object->readSKMG( file );
+      return object;
+    }
+  else if( "SKTM" == type )
+    {
+      boost::shared_ptr<sktm> object( new sktm );
+      object->readSKTM( file );
+      return object;
+    }
+  else if( "SLOD" == type )
+    {
+      boost::shared_ptr<slod> object( new slod );
+      object->readSLOD( file );
+      return object;
+    }
+  else if( "SMAT" == type )
+    {
+      boost::shared_ptr<smat> object( new smat );
+      object->readSMAT( file );
+      return object;
+    }
+  else if( "SPAM" == type )
+    {
+      boost::shared_ptr<spam> object( new spam );
+      object->readSPAM( file );
+      return object;
+    }
+  else if( "SSHT" == type )
+    {
+      boost::shared_ptr<sht> object( new sht );
+      object->readSHT( file );
+      return object;
+    }
+  else if( "STAT" == type )
+    {
+      boost::shared_ptr<stat> object( new stat );
+      object->readSTAT( file );
+      return object;
+    }
+  else if( "STER" == type )
+    {
+      boost::shared_ptr<ster> object( new ster );
+      object->readSTER( file );
+      return object;
+    }
+  else if( "STOT" == type )
+    {
+      boost::shared_ptr<stot> object( new stot );
+      object->readSTOT( file );
+      return object;
+    }
+  else if( "SWTS" == type )
+    {
+      boost::shared_ptr<swts> object( new swts );
+      object->readSWTS( file );
+      return object;
+    }
+  else if( "WSNP" == type )
+    {
+      boost::shared_ptr<ws> object( new ws );
+      object->readWS( file );
+      return object;
+    }
+
+  return boost::shared_ptr<base>();
+}
+
+void batch::printTypeStats( std::ostream &out ) const
+{
+  out << std::setw( 6 ) << "Type"
+      << std::setw( 8 ) << "Files"
+      << std::setw( 8 ) << "Failed"
+      << std::setw( 12 ) << "KBytes"
+      << std::setw( 12 ) << "Seconds"
+      << std::setw( 12 ) << "ms/file"
+      << std::setw( 10 ) << "MB/s"
+      << std::endl;
+
+  for( std::map<std::string, typeStats>::const_iterator i = stats.begin();
+       i != stats.end();
+       ++i )
+    {
+      const typeStats &typeStat = i->second;
+
+      double msPerFile = 0.0;
+      if( typeStat.count > 0 )
+	{
+	  msPerFile = typeStat.seconds * 1000.0 / typeStat.count;
+	}
+
+      double mbPerSecond = 0.0;
+      if( typeStat.seconds > 0.0 )
+	{
+	  mbPerSecond = typeStat.bytes / ( 1024.0 * 1024.0 ) / typeStat.seconds;
+	}
+
+      out << std::setw( 6 ) << ( i->first.empty() ? "?" : i->first )
+	  << std::setw( 8 ) << typeStat.count
+	  << std::setw( 8 ) << typeStat.failures
+	  << std::setw( 12 ) << typeStat.bytes / 1024
+	  << std::setw( 12 ) << std::fixed << std::setprecision( 3 )
+	  << typeStat.seconds
+	  << std::setw( 12 ) << msPerFile
+	  << std::setw( 10 ) << mbPerSecond
+	  << std::endl;
+    }
+}
@@ -0,0 +1,347 @@
+/** -*-c++-*-
+ *  \file   benchIFF.cpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// Benchmark and fuzz harness for the meshLib readers.
+//
+// benchIFF runs every reader known to ml::batch over a corpus of files
+// (plain files and/or every record of TRE archives) and reports MB/s
+// and heap allocations per file for each IFF type. --mutate runs each
+// file again with deterministic corruptions to shake out crashes.
+//
+// Built with -DMESHLIB_FUZZER the same parse path is exposed as a
+// libFuzzer entry point instead of main(), see the fuzzIFF target.
+
+#include <meshLib/batch.hpp>
+#include <meshLib/memoryStream.hpp>
+
+#include <treLib/treClass.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#ifndef MESHLIB_FUZZER
+
+#if __cplusplus >= 201103L
+#define BENCH_THROW_BAD_ALLOC
+#define BENCH_NOTHROW noexcept
+#else
+#define BENCH_THROW_BAD_ALLOC throw( std::bad_alloc )
+#define BENCH_NOTHROW throw()
+#endif
+
+// Count every heap allocation made by the process. Only the main
+// thread parses, so a plain counter is enough.
+static unsigned long long numAllocations = 0;
+
+void *operator new( std::size_t size ) BENCH_THROW_BAD_ALLOC
+{
+  ++numAllocations;
+  void *p = malloc( size ? size : 1 );
+  if( NULL == p )
+    {
+      throw std::bad_alloc();
+    }
+  return p;
+}
+
+void *operator new[]( std::size_t size ) BENCH_THROW_BAD_ALLOC
+{
+  return operator new( size );
+}
+
+void operator delete( void *p ) BENCH_NOTHROW
+{
+  free( p );
+}
+
+void operator delete[]( void *p ) BENCH_NOTHROW
+{
+  free( p );
+}
+
+#endif
+
+/// Parse one in-memory file, readers' chatter goes to a null stream.
+/// memoryStream spares the copy of data into a stringbuf, the readers
+/// still copy every string they keep.
+bool parseBuffer( const std::string &data, std::string &type )
+{
+  ml::memoryStream file( data.data(), data.size() );
+  std::streambuf *coutBuf = std::cout.rdbuf( NULL );
+
+  bool ok = true;
+  try
+    {
+      type = ml::base::getType( file );
+      file.clear();
+      file.seekg( 0, std::ios_base::beg );
+      ok = ( NULL != ml::batch::parseStream( file, type ).get() );
+    }
+  catch( std::exception & )
+    {
+      ok = false;
+    }
+
+  std::cout.rdbuf( coutBuf );
+  std::cout.clear();
+  return ok;
+}
+
+#ifdef MESHLIB_FUZZER
+
+extern "C" int LLVMFuzzerTestOneInput( const unsigned char *data,
+				       std::size_t size )
+{
+  std::string type;
+  parseBuffer( std::string( (const char *)data, size ), type );
+  return 0;
+}
+
+#else
+
+struct typeBench
+{
+  typeBench() : files( 0 ), failures( 0 ), bytes( 0 ), allocations( 0 ),
+		seconds( 0.0 ), mutations( 0 ), mutationFailures( 0 ) {}
+
+  unsigned int files;
+  unsigned int failures;
+  unsigned long long bytes;
+  unsigned long long allocations;
+  double seconds;
+  unsigned int mutations;
+  unsigned int mutationFailures;
+};
+
+void loadCorpus( const std::string &filename,
+		 std::vector< std::pair<std::string, std::string> > &corpus )
+{
+  std::ifstream file( filename.c_str(), std::ios_base::binary );
+  if( !file.is_open() )
+    {
+      std::cout << "Unable to open file: " << filename << std::endl;
+      return;
+    }
+
+  char magic[4] = { 0, 0, 0, 0 };
+  file.read( magic, 4 );
+  file.seekg( 0, std::ios_base::beg );
+
+  if( 0 != memcmp( magic, "EERT", 4 ) )
+    {
+      std::stringstream data;
+      data << file.rdbuf();
+      corpus.push_back( std::make_pair( filename, data.str() ) );
+      return;
+    }
+  file.close();
+
+  treClass tre;
+  if( !tre.readFile( filename ) )
+    {
+      return;
+    }
+
+  for( unsigned int i = 0; i < tre.getNumRecords(); ++i )
+    {
+      std::stringstream *data = tre.saveRecordAsStream( i );
+      if( NULL != data )
+	{
+	  corpus.push_back(
+	    std::make_pair( tre.getFileRecordList()[i].getFileName(),
+			    data->str() )
+	    );
+	  delete data;
+	}
+    }
+}
+
+/// Deterministic corruption number n of data: truncations, byte
+/// flips and bogus chunk sizes.
+std::string mutate( const std::string &data, unsigned int n )
+{
+  std::string result( data );
+  if( result.empty() )
+    {
+      return result;
+    }
+
+  unsigned int seed = ( n + 1 ) * 2654435761u;
+  unsigned int position = seed % result.size();
+  switch( n % 3 )
+    {
+    case 0:
+      result.resize( position );
+      break;
+    case 1:
+      result[position] ^= (char)( 1 + ( seed >> 24 ) % 255 );
+      break;
+    default:
+      // Size fields sit 4 bytes into each header, hit one near position.
+      position = ( position / 4 ) * 4;
+      if( position + 4 <= result.size() )
+	{
+	  result[position] = (char)0x7f;
+	}
+      break;
+    }
+
+  return result;
+}
+
+int main( int argc, char **argv )
+{
+  if( 2 > argc )
+    {
+      std::cout << "benchIFF [--iterations <n>] [--mutate <n>] "
+		<< "<file.tre|file>..." << std::endl;
+      return 0;
+    }
+
+  unsigned int iterations = 1;
+  unsigned int numMutations = 0;
+  std::vector< std::pair<std::string, std::string> > corpus;
+  for( int i = 1; i < argc; ++i )
+    {
+      if( std::string( "--iterations" ) == argv[i] && i+1 < argc )
+	{
+	  iterations = atoi( argv[++i] );
+	}
+      else if( std::string( "--mutate" ) == argv[i] && i+1 < argc )
+	{
+	  numMutations = atoi( argv[++i] );
+	}
+      else
+	{
+	  loadCorpus( argv[i], corpus );
+	}
+    }
+
+  if( 0 == iterations )
+    {
+      iterations = 1;
+    }
+
+  std::cout << "Corpus: " << corpus.size() << " files" << std::endl;
+
+  std::map<std::string, typeBench> results;
+  for( unsigned int i = 0; i < corpus.size(); ++i )
+    {
+      const std::string &data = corpus[i].second;
+      std::string type;
+
+      bool ok = true;
+      unsigned long long allocations = numAllocations;
+      boost::posix_time::ptime start =
+	boost::posix_time::microsec_clock::universal_time();
+
+      for( unsigned int j = 0; j < iterations; ++j )
+	{
+	  ok = parseBuffer( data, type );
+	}
+
+      double seconds = ( boost::posix_time::microsec_clock::universal_time()
+			 - start ).total_microseconds() / 1000000.0;
+      allocations = numAllocations - allocations;
+
+      typeBench &bench = results[type.empty() ? "?" : type];
+      ++bench.files;
+      bench.bytes += data.size() * iterations;
+      bench.allocations += allocations / iterations;
+      bench.seconds += seconds;
+      if( !ok )
+	{
+	  ++bench.failures;
+	}
+
+      if( numMutations > 0 )
+	{
+	  // Leaves the culprit on screen should a reader crash.
+	  std::cout << "Mutating: " << corpus[i].first << std::endl;
+	}
+
+      for( unsigned int j = 0; j < numMutations; ++j )
+	{
+	  std::string mutatedType;
+	  ++bench.mutations;
+	  if( !parseBuffer( mutate( data, j ), mutatedType ) )
+	    {
+	      ++bench.mutationFailures;
+	    }
+	}
+    }
+
+  std::cout << std::setw( 6 ) << "Type"
+	    << std::setw( 8 ) << "Files"
+	    << std::setw( 8 ) << "Failed"
+	    << std::setw( 12 ) << "KBytes"
+	    << std::setw( 10 ) << "MB/s"
+	    << std::setw( 12 ) << "Allocs/file";
+  if( numMutations > 0 )
+    {
+      std::cout << std::setw( 10 ) << "Mutated"
+		<< std::setw( 10 ) << "Rejected";
+    }
+  std::cout << std::endl;
+
+  for( std::map<std::string, typeBench>::const_iterator i = results.begin();
+       i != results.end();
+       ++i )
+    {
+      const typeBench &bench = i->second;
+
+      double mbPerSecond = 0.0;
+      if( bench.seconds > 0.0 )
+	{
+	  mbPerSecond = bench.bytes / ( 1024.0 * 1024.0 ) / bench.seconds;
+	}
+
+      std::cout << std::setw( 6 ) << i->first
+		<< std::setw( 8 ) << bench.files
+		<< std::setw( 8 ) << bench.failures
+		<< std::setw( 12 ) << bench.bytes / iterations / 1024
+		<< std::setw( 10 ) << std::fixed << std::setprecision( 2 )
+		<< mbPerSecond
+		<< std::setw( 12 ) << bench.allocations / bench.files;
+      if( numMutations > 0 )
+	{
+	  std::cout << std::setw( 10 ) << bench.mutations
+		    << std::setw( 10 ) << bench.mutationFailures;
+	}
+      std::cout << std::endl;
+    }
+
+  return 0;
+}
+
+#endif
@@ -29,7 +29,19 @@
 #include <string>
 #include <vector>
 #include <deque>
+#include <map>
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <treLib/treClass.hpp>
+#include <treLib/treDataBlock.hpp>
 
 unsigned int numCols = 0;
 unsigned int numRows = 0;
@@ -1764,15 +1776,501 @@ int readRecord(
 
 
 
+/* ---------------------------------------------------------------------
+ * Structural scan mode
+ *
+ * Walks only the FORM/chunk headers of every IFF, seeking over chunk
+ * data, and builds a histogram of form types, chunk tags and versions.
+ * TRE archives are scanned record by record on several threads, each
+ * thread with its own file handles. Uncompressed records are walked in
+ * place in the TRE, compressed ones are inflated first.
+ * -------------------------------------------------------------------*/
+
+struct scanStats
+{
+    scanStats() : count( 0 ), bytes( 0 ), minSize( 0xffffffff ), maxSize( 0 ) {}
+
+    void add( unsigned int size )
+    {
+	++count;
+	bytes += size;
+	if( size < minSize ) { minSize = size; }
+	if( size > maxSize ) { maxSize = size; }
+    }
+
+    void merge( const scanStats &other )
+    {
+	count += other.count;
+	bytes += other.bytes;
+	if( other.minSize < minSize ) { minSize = other.minSize; }
+	if( other.maxSize > maxSize ) { maxSize = other.maxSize; }
+    }
+
+    unsigned long long count;
+    unsigned long long bytes;
+    unsigned int minSize;
+    unsigned int maxSize;
+};
+
+typedef std::map<std::string, scanStats> scanHistogram;
+
+struct scanResult
+{
+    scanResult() : numFiles( 0 ), numIFF( 0 ), numMalformed( 0 ), bytes( 0 ) {}
+
+    void merge( const scanResult &other )
+    {
+	numFiles += other.numFiles;
+	numIFF += other.numIFF;
+	numMalformed += other.numMalformed;
+	bytes += other.bytes;
+
+	for( scanHistogram::const_iterator i = other.forms.begin();
+	     i != other.forms.end(); ++i )
+	{
+	    forms[i->first].merge( i->second );
+	}
+	for( scanHistogram::const_iterator i = other.chunks.begin();
+	     i != other.chunks.end(); ++i )
+	{
+	    chunks[i->first].merge( i->second );
+	}
+	for( scanHistogram::const_iterator i = other.versions.begin();
+	     i != other.versions.end(); ++i )
+	{
+	    versions[i->first].merge( i->second );
+	}
+    }
+
+    unsigned int numFiles;
+    unsigned int numIFF;
+    unsigned int numMalformed;
+    unsigned long long bytes;
+
+    scanHistogram forms;
+    scanHistogram chunks;
+    scanHistogram versions;
+};
+
+/// Random access to the bytes of one IFF file.
+class scanSource
+{
+public:
+    virtual ~scanSource() {}
+    virtual bool read( unsigned int offset, char *buffer,
+		       unsigned int size ) = 0;
+};
+
+/// IFF stored uncompressed at some offset of an open file.
+class scanFileSource : public scanSource
+{
+public:
+    scanFileSource( std::ifstream &f, unsigned int base )
+	: file( f ), baseOffset( base )
+    {
+    }
+
+    bool read( unsigned int offset, char *buffer, unsigned int size )
+    {
+	file.seekg( baseOffset + offset, std::ios_base::beg );
+	file.read( buffer, size );
+	return file.good();
+    }
+
+protected:
+    std::ifstream &file;
+    unsigned int baseOffset;
+};
+
+/// IFF already in memory.
+class scanMemorySource : public scanSource
+{
+public:
+    scanMemorySource( const char *d, unsigned int s )
+	: data( d ), dataSize( s )
+    {
+    }
+
+    bool read( unsigned int offset, char *buffer, unsigned int size )
+    {
+	if( offset > dataSize || size > dataSize - offset )
+	{
+	    return false;
+	}
+	memcpy( buffer, data + offset, size );
+	return true;
+    }
+
+protected:
+    const char *data;
+    unsigned int dataSize;
+};
+
+bool isTag( const char *tag )
+{
+    for( unsigned int i = 0; i < 4; ++i )
+    {
+	if( tag[i] < ' ' || tag[i] > '~' )
+	{
+	    return false;
+	}
+    }
+    return true;
+}
+
+bool isVersion( const char *tag )
+{
+    for( unsigned int i = 0; i < 4; ++i )
+    {
+	if( tag[i] < '0' || tag[i] > '9' )
+	{
+	    return false;
+	}
+    }
+    return true;
+}
+
+/// Walk the headers of one IFF of length bytes.
+void scanIFF( scanSource &source, unsigned int length, scanResult &result )
+{
+    ++result.numFiles;
+    result.bytes += length;
+
+    char header[12];
+    if( length < 12
+	|| !source.read( 0, header, 4 )
+	|| 0 != memcmp( header, "FORM", 4 ) )
+    {
+	// Not an IFF, eg. a texture or a string file.
+	return;
+    }
+    ++result.numIFF;
+
+    // End offset and owning form type of every open FORM.
+    std::vector< std::pair<unsigned int, std::string> > forms;
+    forms.push_back( std::make_pair( length, std::string( "" ) ) );
+
+    unsigned int offset = 0;
+    while( !forms.empty() )
+    {
+	if( offset >= forms.back().first )
+	{
+	    forms.pop_back();
+	    continue;
+	}
+
+	unsigned int end = forms.back().first;
+	if( end - offset < 8 || !source.read( offset, header, 8 ) )
+	{
+	    ++result.numMalformed;
+	    return;
+	}
+
+	unsigned int size =
+	    ( (unsigned int)(unsigned char)header[4] << 24 )
+	    | ( (unsigned int)(unsigned char)header[5] << 16 )
+	    | ( (unsigned int)(unsigned char)header[6] << 8 )
+	    | (unsigned int)(unsigned char)header[7];
+
+	if( !isTag( header ) || size > end - offset - 8 )
+	{
+	    ++result.numMalformed;
+	    return;
+	}
+
+	if( 0 == memcmp( header, "FORM", 4 ) )
+	{
+	    if( size < 4 || !source.read( offset + 8, header + 8, 4 )
+		|| !isTag( header + 8 ) )
+	    {
+		++result.numMalformed;
+		return;
+	    }
+
+	    std::string type( header + 8, 4 );
+	    std::string owner( type );
+	    result.forms[type].add( size );
+
+	    // Version forms belong to the enclosing form.
+	    if( isVersion( header + 8 ) )
+	    {
+		owner = forms.back().second;
+		result.versions[owner + " " + type].add( size );
+	    }
+
+	    forms.push_back( std::make_pair( offset + 8 + size, owner ) );
+	    offset += 12;
+	}
+	else
+	{
+	    result.chunks[std::string( header, 4 )].add( size );
+	    offset += 8 + size;
+	}
+    }
+}
+
+/// One file to scan, either a TRE record or a plain file.
+struct scanTask
+{
+    int treIndex;
+    std::string filename;
+    unsigned int offset;
+    int format;
+    unsigned int size;
+    unsigned int uncompressedSize;
+};
+
+class scanPool
+{
+public:
+    scanPool( const std::vector<std::string> &tres,
+	      const std::vector<scanTask> &t )
+	: treNames( tres ), tasks( t ), nextTask( 0 )
+    {
+    }
+
+    void worker()
+    {
+	scanResult local;
+	std::vector<std::ifstream *> treFiles( treNames.size(),
+					       (std::ifstream *)NULL );
+
+	while( true )
+	{
+	    unsigned int first, last;
+	    {
+		boost::lock_guard<boost::mutex> lock( mutex );
+		first = nextTask;
+		last = std::min<unsigned int>( first + 64, tasks.size() );
+		nextTask = last;
+	    }
+
+	    if( first >= last )
+	    {
+		break;
+	    }
+
+	    for( unsigned int i = first; i < last; ++i )
+	    {
+		scanTask const &task = tasks[i];
+		if( task.treIndex < 0 )
+		{
+		    std::ifstream file( task.filename.c_str(),
+					std::ios_base::binary );
+		    file.seekg( 0, std::ios_base::end );
+		    unsigned int length = file.tellg();
+		    scanFileSource source( file, 0 );
+		    scanIFF( source, length, local );
+		    continue;
+		}
+
+		std::ifstream *&file = treFiles[task.treIndex];
+		if( NULL == file )
+		{
+		    file = new std::ifstream( treNames[task.treIndex].c_str(),
+					      std::ios_base::binary );
+		}
+		file->clear();
+		file->seekg( task.offset, std::ios_base::beg );
+
+		if( 2 != task.format )
+		{
+		    scanFileSource source( *file, task.offset );
+		    scanIFF( source, task.uncompressedSize, local );
+		}
+		else
+		{
+		    treDataBlock block;
+		    if( block.readAndUncompress( *file, task.format, task.size,
+						 task.uncompressedSize ) )
+		    {
+			scanMemorySource source( block.getUncompressedDataPtr(),
+						 block.getUncompressedSize() );
+			scanIFF( source, block.getUncompressedSize(), local );
+		    }
+		    else
+		    {
+			++local.numFiles;
+			++local.numMalformed;
+		    }
+		}
+	    }
+	}
+
+	for( unsigned int i = 0; i < treFiles.size(); ++i )
+	{
+	    delete treFiles[i];
+	}
+
+	boost::lock_guard<boost::mutex> lock( mutex );
+	result.merge( local );
+    }
+
+    scanResult result;
+
+protected:
+    const std::vector<std::string> &treNames;
+    const std::vector<scanTask> &tasks;
+    unsigned int nextTask;
+    boost::mutex mutex;
+};
+
+bool compareScanCount( const std::pair<std::string, scanStats> &a,
+		       const std::pair<std::string, scanStats> &b )
+{
+    return a.second.count > b.second.count;
+}
+
+void printHistogram( const std::string &title, const scanHistogram &histogram )
+{
+    std::vector< std::pair<std::string, scanStats> >
+	sorted( histogram.begin(), histogram.end() );
+    std::sort( sorted.begin(), sorted.end(), compareScanCount );
+
+    std::cout << std::endl << title << " (" << sorted.size() << ")"
+	      << std::endl;
+    std::cout << std::setw( 12 ) << "Tag"
+	      << std::setw( 12 ) << "Count"
+	      << std::setw( 14 ) << "Bytes"
+	      << std::setw( 12 ) << "Min"
+	      << std::setw( 12 ) << "Max"
+	      << std::setw( 12 ) << "Avg"
+	      << std::endl;
+
+    for( unsigned int i = 0; i < sorted.size(); ++i )
+    {
+	const scanStats &stats = sorted[i].second;
+	std::cout << std::setw( 12 ) << ( "'" + sorted[i].first + "'" )
+		  << std::setw( 12 ) << stats.count
+		  << std::setw( 14 ) << stats.bytes
+		  << std::setw( 12 ) << stats.minSize
+		  << std::setw( 12 ) << stats.maxSize
+		  << std::setw( 12 ) << ( stats.bytes / stats.count )
+		  << std::endl;
+    }
+}
+
+int scanFiles( const std::vector<std::string> &filenames,
+	       unsigned int numThreads )
+{
+    boost::posix_time::ptime start =
+	boost::posix_time::microsec_clock::universal_time();
+
+    std::vector<std::string> treNames;
+    std::vector<scanTask> tasks;
+
+    for( unsigned int i = 0; i < filenames.size(); ++i )
+    {
+	std::ifstream file( filenames[i].c_str(), std::ios_base::binary );
+	if( !file.is_open() )
+	{
+	    std::cout << "Unable to open file: " << filenames[i] << std::endl;
+	    continue;
+	}
+
+	char magic[4] = { 0, 0, 0, 0 };
+	file.read( magic, 4 );
+	file.close();
+
+	scanTask task;
+	if( 0 != memcmp( magic, "EERT", 4 ) )
+	{
+	    task.treIndex = -1;
+	    task.filename = filenames[i];
+	    tasks.push_back( task );
+	    continue;
+	}
+
+	// Only the record table is needed from the TRE itself.
+	treClass tre;
+	if( !tre.readFile( filenames[i] ) )
+	{
+	    continue;
+	}
+
+	task.treIndex = treNames.size();
+	treNames.push_back( filenames[i] );
+
+	const std::vector<treFileRecord> &records = tre.getFileRecordList();
+	for( unsigned int j = 0; j < records.size(); ++j )
+	{
+	    task.offset = records[j].getOffset();
+	    task.format = records[j].getFormat();
+	    task.size = records[j].getSize();
+	    task.uncompressedSize = records[j].getUncompressedSize();
+	    tasks.push_back( task );
+	}
+    }
+
+    if( 0 == numThreads )
+    {
+	numThreads = boost::thread::hardware_concurrency();
+    }
+    if( 0 == numThreads )
+    {
+	numThreads = 1;
+    }
+
+    std::cout << "Scanning " << tasks.size() << " files in "
+	      << treNames.size() << " TRE files with " << numThreads
+	      << " threads" << std::endl;
+
+    scanPool pool( treNames, tasks );
+    boost::thread_group threads;
+    for( unsigned int i = 0; i < numThreads; ++i )
+    {
+	threads.create_thread( boost::bind( &scanPool::worker, &pool ) );
+    }
+    threads.join_all();
+
+    double seconds = ( boost::posix_time::microsec_clock::universal_time()
+		       - start ).total_microseconds() / 1000000.0;
+
+    const scanResult &result = pool.result;
+    std::cout << "Files: " << result.numFiles
+	      << " IFF: " << result.numIFF
+	      << " Malformed: " << result.numMalformed
+	      << " MBytes: " << result.bytes / ( 1024 * 1024 )
+	      << " Seconds: " << seconds
+	      << std::endl;
+
+    printHistogram( "FORM types", result.forms );
+    printHistogram( "Chunk tags", result.chunks );
+    printHistogram( "Versions", result.versions );
+
+    return 0;
+}
+
 int main( int argc, char **argv )
 {
 
     if( 2 > argc )
     {
 	std::cout << "iffDump <file>" << std::endl;
+	std::cout << "iffDump --scan [--threads <n>] <file.tre|file>..."
+		  << std::endl;
 	return 0;
     }
 
+    if( std::string( "--scan" ) == argv[1] )
+    {
+	unsigned int numThreads = 0;
+	std::vector<std::string> filenames;
+	for( int i = 2; i < argc; ++i )
+	{
+	    if( std::string( "--threads" ) == argv[i] && i+1 < argc )
+	    {
+		numThreads = atoi( argv[++i] );
+	    }
+	    else
+	    {
+		filenames.push_back( argv[i] );
+	    }
+	}
+
+	return scanFiles( filenames, numThreads );
+    }
+
     for( int i = 1; i < argc; ++i )
     {
 	std::ifstream meshFile( argv[i] );
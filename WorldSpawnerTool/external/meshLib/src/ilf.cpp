@@ -30,6 +30,7 @@
 using namespace ml;
 
 ilf::ilf()
+  : names( new stringTable )
 {
 }
 
@@ -49,8 +50,8 @@ bool ilf::getNode( const unsigned int &index,
       return false;
     }
   
-  fileName = nodeFilename[index];
-  zoneName = nodeZone[index];
+  fileName = *nodeFilename[index];
+  zoneName = *nodeZone[index];
   transformMatrix = nodeMatrix[index];
   translateVector = nodeVector[index];
   
@@ -188,16 +189,16 @@ unsigned int ilf::readNODE( std::istream &file )
 	      << ": " << nodeSize-8 << " bytes"
 	      << std::endl;
 
-    std::string objectFilename;
-    total += base::read( file, objectFilename );
+    const std::string *objectFilename;
+    total += base::read( file, *names, objectFilename );
     nodeFilename.push_back( objectFilename );
 
-    std::string objectZone;
-    total += base::read( file, objectZone );
+    const std::string *objectZone;
+    total += base::read( file, *names, objectZone );
     nodeZone.push_back( objectZone );
 
-    std::cout << "Object Filename: " << objectFilename << std::endl;
-    std::cout << "Object Zone: " << objectZone << std::endl;
+    std::cout << "Object Filename: " << *objectFilename << std::endl;
+    std::cout << "Object Zone: " << *objectZone << std::endl;
 
     std::cout << "Transform matrix: " << std::endl;
 
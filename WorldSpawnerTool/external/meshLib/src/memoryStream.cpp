@@ -0,0 +1,80 @@
+/** -*-c++-*-
+ *  \class  memoryStream
+ *  \file   memoryStream.cpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <meshLib/memoryStream.hpp>
+
+using namespace ml;
+
+memoryStreamBuf::memoryStreamBuf( const char *data, unsigned int size )
+{
+  char *begin = const_cast<char *>( data );
+  setg( begin, begin, begin + size );
+}
+
+std::streambuf::pos_type
+memoryStreamBuf::seekoff( off_type offset,
+			  std::ios_base::seekdir dir,
+			  std::ios_base::openmode which )
+{
+  if( 0 == ( which & std::ios_base::in ) )
+    {
+      return pos_type( off_type( -1 ) );
+    }
+
+  off_type position = offset;
+  if( std::ios_base::cur == dir )
+    {
+      position += gptr() - eback();
+    }
+  else if( std::ios_base::end == dir )
+    {
+      position += egptr() - eback();
+    }
+
+  if( position < 0 || position > egptr() - eback() )
+    {
+      return pos_type( off_type( -1 ) );
+    }
+
+  setg( eback(), eback() + position, egptr() );
+  return pos_type( position );
+}
+
+std::streambuf::pos_type
+memoryStreamBuf::seekpos( pos_type position,
+			  std::ios_base::openmode which )
+{
+  return seekoff( off_type( position ), std::ios_base::beg, which );
+}
+
+memoryStream::memoryStream( const char *data, unsigned int size )
+  : std::istream( NULL ), buffer( data, size )
+{
+  rdbuf( &buffer );
+}
+
+memoryStream::~memoryStream()
+{
+}
@@ -0,0 +1,529 @@
+/** -*-c++-*-
+ *  \class  meshCache
+ *  \file   meshCache.cpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <meshLib/meshCache.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/locks.hpp>
+
+using namespace ml;
+
+// Cache file layout, all values are native 32 bit unsigned ints and
+// every offset is from the start of the file and 4 byte aligned:
+//
+// header:  'MLMC', version, md5[16], pathOffset, pathLength,
+//          numSurfaces, surfaceOffset
+// surface: shaderOffset, numVertices, positionOffset, normalOffset,
+//          colorOffset, numTexCoordSets, texCoordOffset[MAX_TEXTURES],
+//          numGroups, groupOffset
+// group:   indexOffset, numIndices
+//
+// Strings are NUL terminated.
+namespace
+{
+  const unsigned int HEADER_SIZE = 40;
+  const unsigned int SURFACE_SIZE = ( 8 + MAX_TEXTURES ) * 4;
+  const unsigned int GROUP_SIZE = 8;
+
+  void align( std::vector<char> &buffer )
+  {
+    while( buffer.size() % 4 )
+      {
+	buffer.push_back( 0 );
+      }
+  }
+
+  unsigned int append( std::vector<char> &buffer,
+		       const void *data,
+		       unsigned int size )
+  {
+    align( buffer );
+    unsigned int offset = buffer.size();
+    buffer.insert( buffer.end(),
+		   static_cast<const char *>( data ),
+		   static_cast<const char *>( data ) + size );
+    return offset;
+  }
+
+  unsigned int appendString( std::vector<char> &buffer,
+			     const std::string &value )
+  {
+    return append( buffer, value.c_str(), value.size() + 1 );
+  }
+
+  unsigned int appendZero( std::vector<char> &buffer, unsigned int size )
+  {
+    align( buffer );
+    unsigned int offset = buffer.size();
+    buffer.resize( buffer.size() + size, 0 );
+    return offset;
+  }
+
+  template< class T >
+  unsigned int appendVector( std::vector<char> &buffer,
+			     const std::vector<T> &values )
+  {
+    if( values.empty() )
+      {
+	return 0;
+      }
+    return append( buffer, &(values[0]), values.size() * sizeof( T ) );
+  }
+
+  void put( std::vector<char> &buffer, unsigned int offset,
+	    unsigned int value )
+  {
+    memcpy( &(buffer[offset]), &value, sizeof( value ) );
+  }
+
+  unsigned int get( const char *data, unsigned int offset )
+  {
+    unsigned int value;
+    memcpy( &value, data + offset, sizeof( value ) );
+    return value;
+  }
+}
+
+meshCache::surface::surface()
+  : shader( "" ),
+    numVertices( 0 ),
+    positions( NULL ),
+    normals( NULL ),
+    colors( NULL ),
+    numTexCoordSets( 0 )
+{
+  for( unsigned int i = 0; i < MAX_TEXTURES; ++i )
+    {
+      texCoords[i] = NULL;
+    }
+}
+
+meshCache::meshCache( const std::string &dir )
+  : directory( dir ),
+    numHits( 0 ),
+    numMisses( 0 )
+{
+  if( !directory.empty()
+      && '/' != directory[directory.size()-1]
+      && '\\' != directory[directory.size()-1] )
+    {
+      directory.push_back( '/' );
+    }
+}
+
+meshCache::~meshCache()
+{
+}
+
+std::string meshCache::getCacheFilename( const std::string &path )
+{
+  std::string filename( path );
+  for( unsigned int i = 0; i < filename.size(); ++i )
+    {
+      if( '/' == filename[i] || '\\' == filename[i] || ':' == filename[i] )
+	{
+	  filename[i] = '_';
+	}
+    }
+
+  return filename + ".mlc";
+}
+
+boost::shared_ptr<meshCache::entry>
+meshCache::find( const std::string &path,
+		 const std::vector<unsigned char> &md5sum )
+{
+  boost::shared_ptr<entry> cached =
+    map( directory + getCacheFilename( path ), path, md5sum );
+
+  boost::lock_guard<boost::mutex> lock( mutex );
+  if( NULL == cached.get() )
+    {
+      ++numMisses;
+    }
+  else
+    {
+      ++numHits;
+    }
+
+  return cached;
+}
+
+boost::shared_ptr<meshCache::entry>
+meshCache::store( const std::string &path,
+		  const std::vector<unsigned char> &md5sum,
+		  msh &mesh )
+{
+  std::vector<flatSurface> surfaces( mesh.getNumIndexTables() );
+
+  mshVertexData *vData;
+  mshVertexIndex *iData;
+  std::string shaderFilename;
+  float x, y, z;
+  unsigned char argb[4];
+  unsigned int numTexCoordPairs;
+  float texCoord[MAX_TEXTURES*2];
+
+  for( unsigned int indexTable = 0;
+       indexTable < mesh.getNumIndexTables();
+       ++indexTable )
+    {
+      flatSurface &flat = surfaces[indexTable];
+
+      mesh.getIndex( indexTable, &vData, &iData, shaderFilename );
+      flat.shader = mesh.getShader( iData->getShaderIndex() );
+
+      unsigned int numVertices = vData->getNumVertices();
+      flat.positions.reserve( numVertices * 3 );
+      flat.normals.reserve( numVertices * 3 );
+      flat.colors.reserve( numVertices * 4 );
+
+      for( unsigned int i = 0; i < numVertices; ++i )
+	{
+	  const mshVertex *vertex = vData->getVertex( i );
+
+	  vertex->getPosition( x, y, z );
+	  flat.positions.push_back( x );
+	  flat.positions.push_back( y );
+	  flat.positions.push_back( z );
+
+	  vertex->getNormal( x, y, z );
+	  flat.normals.push_back( x );
+	  flat.normals.push_back( y );
+	  flat.normals.push_back( z );
+
+	  vertex->getColor( argb );
+	  flat.colors.push_back( argb[1]/255.0f );
+	  flat.colors.push_back( argb[2]/255.0f );
+	  flat.colors.push_back( argb[3]/255.0f );
+	  flat.colors.push_back( argb[0]/255.0f );
+
+	  vertex->getTexCoords( numTexCoordPairs, texCoord );
+	  if( 0 == i )
+	    {
+	      flat.texCoords.resize( numTexCoordPairs );
+	    }
+
+	  for( unsigned int j = 0; j < flat.texCoords.size(); ++j )
+	    {
+	      std::vector<float> &set = flat.texCoords[j];
+	      if( j < numTexCoordPairs )
+		{
+		  set.push_back( texCoord[j*2] );
+		  set.push_back( texCoord[(j*2)+1] );
+		}
+	      else
+		{
+		  set.push_back( 0.0f );
+		  set.push_back( 0.0f );
+		}
+	    }
+	}
+
+      flat.groups.resize( 1 );
+      std::vector<unsigned int> &indices = flat.groups[0];
+      indices.reserve( iData->getNumIndices() );
+      for( unsigned int i = 0; i < iData->getNumIndices(); ++i )
+	{
+	  indices.push_back( iData->getIndex( i ) );
+	}
+    }
+
+  std::string filename( directory + getCacheFilename( path ) );
+  if( !write( filename, path, md5sum, surfaces ) )
+    {
+      return boost::shared_ptr<entry>();
+    }
+
+  return map( filename, path, md5sum );
+}
+
+boost::shared_ptr<meshCache::entry>
+meshCache::store( const std::string &path,
+		  const std::vector<unsigned char> &md5sum,
+		  const skmg &mesh )
+{
+  std::vector<flatSurface> surfaces( mesh.getNumPsdt() );
+
+  float x, y, z;
+  for( unsigned int psdtNum = 0; psdtNum < mesh.getNumPsdt(); ++psdtNum )
+    {
+      flatSurface &flat = surfaces[psdtNum];
+      const skmg::psdt &newPsdt = mesh.getPsdt( psdtNum );
+
+      flat.shader = newPsdt.getShader();
+      flat.texCoords.resize( 1 );
+
+      unsigned int numVertices = newPsdt.getNumVertex();
+      for( unsigned int i = 0; i < numVertices; ++i )
+	{
+	  newPsdt.getVertex( i, x, y, z );
+	  flat.positions.push_back( x );
+	  flat.positions.push_back( y );
+	  flat.positions.push_back( z );
+
+	  newPsdt.getNormal( i, x, y, z );
+	  flat.normals.push_back( x );
+	  flat.normals.push_back( y );
+	  flat.normals.push_back( z );
+
+	  // Skeletal meshes carry no vertex color.
+	  flat.colors.insert( flat.colors.end(), 4, 1.0f );
+
+	  newPsdt.getTexCoord( i, x, y );
+	  flat.texCoords[0].push_back( x );
+	  flat.texCoords[0].push_back( y );
+	}
+
+      // One triangle list per bone group (starting at -1), then the
+      // plain triangle list.
+      for( unsigned short int i = 0; i <= mesh.getNumGroups(); ++i )
+	{
+	  flat.groups.push_back( newPsdt.getOTriangles( i-1 ) );
+	}
+      flat.groups.push_back( newPsdt.getTriangles() );
+    }
+
+  std::string filename( directory + getCacheFilename( path ) );
+  if( !write( filename, path, md5sum, surfaces ) )
+    {
+      return boost::shared_ptr<entry>();
+    }
+
+  return map( filename, path, md5sum );
+}
+
+bool meshCache::write( const std::string &filename,
+		       const std::string &path,
+		       const std::vector<unsigned char> &md5sum,
+		       const std::vector<flatSurface> &surfaces )
+{
+  if( 16 != md5sum.size() )
+    {
+      return false;
+    }
+
+  std::vector<char> buffer;
+
+  appendZero( buffer, HEADER_SIZE );
+  memcpy( &(buffer[0]), "MLMC", 4 );
+  put( buffer, 4, VERSION );
+  memcpy( &(buffer[8]), &(md5sum[0]), 16 );
+  put( buffer, 24, appendString( buffer, path ) );
+  put( buffer, 28, path.size() );
+  put( buffer, 32, surfaces.size() );
+
+  unsigned int surfaceOffset = appendZero( buffer,
+					   SURFACE_SIZE * surfaces.size() );
+  put( buffer, 36, surfaceOffset );
+
+  for( unsigned int s = 0; s < surfaces.size(); ++s )
+    {
+      const flatSurface &flat = surfaces[s];
+      unsigned int record = surfaceOffset + ( s * SURFACE_SIZE );
+
+      put( buffer, record, appendString( buffer, flat.shader ) );
+      put( buffer, record+4, flat.positions.size() / 3 );
+      put( buffer, record+8, appendVector( buffer, flat.positions ) );
+      put( buffer, record+12, appendVector( buffer, flat.normals ) );
+      put( buffer, record+16, appendVector( buffer, flat.colors ) );
+
+      unsigned int numTexCoordSets = flat.texCoords.size();
+      if( numTexCoordSets > MAX_TEXTURES )
+	{
+	  numTexCoordSets = MAX_TEXTURES;
+	}
+      put( buffer, record+20, numTexCoordSets );
+      for( unsigned int i = 0; i < numTexCoordSets; ++i )
+	{
+	  put( buffer, record+24+(i*4),
+	       appendVector( buffer, flat.texCoords[i] ) );
+	}
+
+      unsigned int groupRecord = record + 24 + ( MAX_TEXTURES * 4 );
+      unsigned int groupOffset = appendZero( buffer,
+					     GROUP_SIZE * flat.groups.size() );
+      put( buffer, groupRecord, flat.groups.size() );
+      put( buffer, groupRecord+4, groupOffset );
+
+      for( unsigned int i = 0; i < flat.groups.size(); ++i )
+	{
+	  put( buffer, groupOffset+(i*GROUP_SIZE),
+	       appendVector( buffer, flat.groups[i] ) );
+	  put( buffer, groupOffset+(i*GROUP_SIZE)+4, flat.groups[i].size() );
+	}
+    }
+
+  // Write to a temporary file first so a mapped or half written
+  // file is never seen under the final name.
+  boost::lock_guard<boost::mutex> lock( mutex );
+
+  std::string tmpFilename( filename + ".tmp" );
+  std::ofstream outfile( tmpFilename.c_str(), std::ios_base::binary );
+  if( !outfile.is_open() )
+    {
+      std::cout << "Unable to write mesh cache file: " << tmpFilename
+		<< std::endl;
+      return false;
+    }
+
+  outfile.write( &(buffer[0]), buffer.size() );
+  outfile.close();
+
+  std::remove( filename.c_str() );
+  if( 0 != std::rename( tmpFilename.c_str(), filename.c_str() ) )
+    {
+      std::remove( tmpFilename.c_str() );
+      return false;
+    }
+
+  return true;
+}
+
+boost::shared_ptr<meshCache::entry>
+meshCache::map( const std::string &filename,
+		const std::string &path,
+		const std::vector<unsigned char> &md5sum )
+{
+  boost::shared_ptr<entry> cached( new entry );
+
+  try
+    {
+      boost::interprocess::file_mapping file( filename.c_str(),
+					      boost::interprocess::read_only );
+      cached->region.reset(
+	new boost::interprocess::mapped_region( file,
+						boost::interprocess::read_only )
+	);
+    }
+  catch( std::exception & )
+    {
+      return boost::shared_ptr<entry>();
+    }
+
+  const char *data = static_cast<const char *>( cached->region->get_address() );
+  const unsigned int size = cached->region->get_size();
+
+  // Every offset and array must be inside the file.
+#define INSIDE( offset, bytes ) \
+  ( (offset) <= size && (bytes) <= size - (offset) )
+
+  if( size < HEADER_SIZE
+      || 0 != memcmp( data, "MLMC", 4 )
+      || VERSION != get( data, 4 )
+      || 16 != md5sum.size()
+      || 0 != memcmp( data + 8, &(md5sum[0]), 16 ) )
+    {
+      return boost::shared_ptr<entry>();
+    }
+
+  unsigned int pathOffset = get( data, 24 );
+  unsigned int pathLength = get( data, 28 );
+  unsigned int numSurfaces = get( data, 32 );
+  unsigned int surfaceOffset = get( data, 36 );
+
+  if( !INSIDE( pathOffset, pathLength )
+      || path != std::string( data + pathOffset, pathLength )
+      || numSurfaces > size / SURFACE_SIZE
+      || !INSIDE( surfaceOffset, numSurfaces * SURFACE_SIZE ) )
+    {
+      return boost::shared_ptr<entry>();
+    }
+
+  cached->surfaces.resize( numSurfaces );
+  for( unsigned int s = 0; s < numSurfaces; ++s )
+    {
+      surface &surf = cached->surfaces[s];
+      unsigned int record = surfaceOffset + ( s * SURFACE_SIZE );
+
+      unsigned int shaderOffset = get( data, record );
+      surf.numVertices = get( data, record+4 );
+      unsigned int positionOffset = get( data, record+8 );
+      unsigned int normalOffset = get( data, record+12 );
+      unsigned int colorOffset = get( data, record+16 );
+      surf.numTexCoordSets = get( data, record+20 );
+
+      if( !INSIDE( shaderOffset, 1 )
+	  || NULL == memchr( data + shaderOffset, 0, size - shaderOffset )
+	  || surf.numVertices > size / 16
+	  || !INSIDE( positionOffset, surf.numVertices * 12 )
+	  || !INSIDE( normalOffset, surf.numVertices * 12 )
+	  || !INSIDE( colorOffset, surf.numVertices * 16 )
+	  || surf.numTexCoordSets > MAX_TEXTURES )
+	{
+	  return boost::shared_ptr<entry>();
+	}
+
+      surf.shader = data + shaderOffset;
+      surf.positions = reinterpret_cast<const float *>( data + positionOffset );
+      surf.normals = reinterpret_cast<const float *>( data + normalOffset );
+      surf.colors = reinterpret_cast<const float *>( data + colorOffset );
+
+      for( unsigned int i = 0; i < surf.numTexCoordSets; ++i )
+	{
+	  unsigned int texCoordOffset = get( data, record+24+(i*4) );
+	  if( !INSIDE( texCoordOffset, surf.numVertices * 8 ) )
+	    {
+	      return boost::shared_ptr<entry>();
+	    }
+	  surf.texCoords[i] =
+	    reinterpret_cast<const float *>( data + texCoordOffset );
+	}
+
+      unsigned int groupRecord = record + 24 + ( MAX_TEXTURES * 4 );
+      unsigned int numGroups = get( data, groupRecord );
+      unsigned int groupOffset = get( data, groupRecord+4 );
+      if( numGroups > size / GROUP_SIZE
+	  || !INSIDE( groupOffset, numGroups * GROUP_SIZE ) )
+	{
+	  return boost::shared_ptr<entry>();
+	}
+
+      for( unsigned int i = 0; i < numGroups; ++i )
+	{
+	  unsigned int indexOffset = get( data, groupOffset+(i*GROUP_SIZE) );
+	  unsigned int numIndices = get( data, groupOffset+(i*GROUP_SIZE)+4 );
+	  if( numIndices > size / 4
+	      || !INSIDE( indexOffset, numIndices * 4 ) )
+	    {
+	      return boost::shared_ptr<entry>();
+	    }
+
+	  surf.groupSize.push_back( numIndices );
+	  surf.groupIndices.push_back(
+	    reinterpret_cast<const unsigned int *>( data + indexOffset )
+	    );
+	}
+    }
+
+#undef INSIDE
+
+  return cached;
+}
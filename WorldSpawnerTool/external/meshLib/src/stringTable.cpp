@@ -0,0 +1,64 @@
+/** -*-c++-*-
+ *  \class  stringTable
+ *  \file   stringTable.cpp
+
+ meshLib is used for the parsing and exporting .msh models.
+ Copyright (C) 2006-2009 Kenneth R. Sewell III
+
+ This file is part of meshLib.
+
+ meshLib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ meshLib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with meshLib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <meshLib/stringTable.hpp>
+
+using namespace ml;
+
+stringTable::stringTable()
+{
+}
+
+stringTable::~stringTable()
+{
+}
+
+const std::string &stringTable::intern( const char *data, unsigned int size )
+{
+  key.assign( data, size );
+  return intern( key );
+}
+
+const std::string &stringTable::intern( const std::string &data )
+{
+  std::set<std::string>::const_iterator i = strings.find( data );
+  if( i == strings.end() )
+    {
+      i = strings.insert( data ).first;
+    }
+
+  return *i;
+}
+
+void stringTable::clear()
+{
+  strings.clear();
+}
+
+const std::string &stringTable::empty()
+{
+  static const std::string emptyString;
+  return emptyString;
+}
@@ -29,8 +29,74 @@
 #include <bitset>
 #include <cstdlib>
 
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/locks.hpp>
+
 using namespace ml;
 
+namespace
+{
+  // Rows handed out at a time by trn::applyLayers. Small enough to keep
+  // every thread busy until the end, large enough that the lock is rare.
+  const unsigned int rowsPerBand = 8;
+
+  // Heightfield shared by the threads of trn::applyLayers. Each thread
+  // takes the next band of rows and runs every layer over it.
+  struct layerBands
+  {
+    const std::vector< boost::shared_ptr<trnLayer> > *layers;
+    float originX;
+    float originY;
+    float spacingX;
+    float spacingY;
+    unsigned int numRows;
+    unsigned int numCols;
+    float *data;
+
+    boost::mutex mutex;
+    unsigned int nextRow;
+
+    void worker()
+    {
+      while( true )
+	{
+	  unsigned int firstRow;
+	  {
+	    boost::lock_guard<boost::mutex> lock( mutex );
+	    if( nextRow >= numRows )
+	      {
+		return;
+	      }
+	    firstRow = nextRow;
+	    nextRow += rowsPerBand;
+	  }
+
+	  unsigned int lastRow = firstRow + rowsPerBand;
+	  if( lastRow > numRows )
+	    {
+	      lastRow = numRows;
+	    }
+
+	  for( std::vector< boost::shared_ptr<trnLayer> >::const_iterator
+		 currentLayer = layers->begin();
+	       currentLayer != layers->end();
+	       ++currentLayer )
+	    {
+	      (*currentLayer)->applyRows( originX,
+					  originY,
+					  spacingX,
+					  spacingY,
+					  firstRow,
+					  lastRow,
+					  numCols,
+					  data );
+	    }
+	}
+    }
+  };
+}
+
 trn::trn()
 {
 }
@@ -1160,21 +1226,44 @@ bool trn::applyLayers( const float &originX,
 		       const float &spacingY,
 		       const unsigned int &numRows,
 		       const unsigned int &numCols,
-		       float *data) const
+		       float *data,
+		       unsigned int numThreads ) const
 {
-  for( std::list< boost::shared_ptr<trnLayer> >::const_iterator
-	 currentLayer = layerList.begin();
-       currentLayer != layerList.end();
-       ++currentLayer )
-    {
-      (*currentLayer)->apply( originX,
-			      originY,
-			      spacingX,
-			      spacingY,
-			      numRows,
-			      numCols,
-			      data ) ;
+  layerBands bands;
+  bands.layers = &layerList;
+  bands.originX = originX;
+  bands.originY = originY;
+  bands.spacingX = spacingX;
+  bands.spacingY = spacingY;
+  bands.numRows = numRows;
+  bands.numCols = numCols;
+  bands.data = data;
+  bands.nextRow = 0;
+
+  if( 0 == numThreads )
+    {
+      numThreads = boost::thread::hardware_concurrency();
+    }
+
+  unsigned int numBands = ( numRows + rowsPerBand - 1 ) / rowsPerBand;
+  if( numThreads > numBands )
+    {
+      numThreads = numBands;
+    }
+
+  // Small heightfields are not worth the thread start up.
+  if( numThreads <= 1 )
+    {
+      bands.worker();
+      return true;
+    }
+
+  boost::thread_group pool;
+  for( unsigned int i = 0; i < numThreads; ++i )
+    {
+      pool.create_thread( boost::bind( &layerBands::worker, &bands ) );
     }
+  pool.join_all();
 
   return true;
 }
@@ -42,7 +42,19 @@ void trnLayer::apply( const float &originX,
 		      const unsigned int &numCols,
 		      float *data) const
 {
-  for( unsigned int row = 0; row < numRows; ++row )
+  applyRows( originX, originY, spacingX, spacingY, 0, numRows, numCols, data );
+}
+
+void trnLayer::applyRows( const float &originX,
+			  const float &originY,
+			  const float &spacingX,
+			  const float &spacingY,
+			  const unsigned int &firstRow,
+			  const unsigned int &lastRow,
+			  const unsigned int &numCols,
+			  float *data) const
+{
+  for( unsigned int row = firstRow; row < lastRow; ++row )
     {
       float currentY = originY + ( spacingY * row );
       for( unsigned int col = 0; col < numCols; ++col )
@@ -56,7 +68,7 @@ void trnLayer::apply( const float &originX,
 	  
 	  unsigned int offset = (numCols * row)+col;
 	  
-	  for( std::list< boost::shared_ptr<trnAffector> >::const_iterator
+	  for( std::vector< boost::shared_ptr<trnAffector> >::const_iterator
 		 affector = affectorList.begin();
 	       affector != affectorList.end();
 	       ++affector )
@@ -66,18 +78,19 @@ void trnLayer::apply( const float &originX,
 	}
     }
   
-  for( std::list< boost::shared_ptr<trnLayer> >::const_iterator
+  for( std::vector< boost::shared_ptr<trnLayer> >::const_iterator
 	 currentLayer = layerList.begin();
        currentLayer != layerList.end();
        ++currentLayer )
     {
-      (*currentLayer)->apply( originX,
-			      originY,
-			      spacingX,
-			      spacingY,
-			      numRows,
-			      numCols,
-			      data ) ;
+      (*currentLayer)->applyRows( originX,
+				  originY,
+				  spacingX,
+				  spacingY,
+				  firstRow,
+				  lastRow,
+				  numCols,
+				  data ) ;
     }
 }
 
@@ -319,7 +332,7 @@ unsigned int trnLayer::read( std::istream &file,
 
 bool trnLayer::isInBounds( const float &X, const float &Y ) const
 {
-  for( std::list< boost::shared_ptr<trnBoundary> >::const_iterator
+  for( std::vector< boost::shared_ptr<trnBoundary> >::const_iterator
 	 currentBoundary = boundaryList.begin();
        currentBoundary != boundaryList.end();
        ++currentBoundary )
@@ -34,6 +34,7 @@
 using namespace ml;
 
 ws::ws()
+  : names( new stringTable )
 {
 }
 
@@ -211,7 +212,7 @@ unsigned int ws::readWS( std::istream &file )
     std::vector< wsNode >::iterator node;
     for( node = nodes.begin(); node != nodes.end(); ++node )
     {
-	node->objectFilename = objectNames[node->objectIndex];
+	node->objectFilename = *objectNames[node->objectIndex];
 	node->print();
     }
 
@@ -414,11 +415,12 @@ unsigned int ws::writeOTNL( std::ofstream &outfile )
 {
   ++maxObjectIndex;
   std::cout << "Resizing vector to " << maxObjectIndex << std::endl;
-  objectNames.resize( maxObjectIndex );
+  objectNames.resize( maxObjectIndex, &stringTable::empty() );
   for( currentNode = nodes.begin(); currentNode != nodes.end();
        ++currentNode )
     {
-      objectNames[currentNode->objectIndex] = currentNode->objectFilename;
+      objectNames[currentNode->objectIndex] =
+	&names->intern( currentNode->objectFilename );
     }
   
   unsigned int total = 0;
@@ -435,10 +437,10 @@ unsigned int ws::writeOTNL( std::ofstream &outfile )
   for( unsigned int i = 0; i < numObjects; ++i )
     {
       outfile.write(
-		    objectNames[i].c_str(),
-		    static_cast<unsigned int>( objectNames[i].size()+1 )
+		    objectNames[i]->c_str(),
+		    static_cast<unsigned int>( objectNames[i]->size()+1 )
 		    );
-      total += objectNames[i].size()+1;
+      total += objectNames[i]->size()+1;
     }
 
   unsigned int nodeEndPosition = outfile.tellp();
@@ -478,8 +480,8 @@ unsigned int ws::readOTNL( std::istream &file )
 
     for( unsigned int i = 0; i < numObjects; ++i )
     {
-      std::string objectName;
-      total += base::read( file, objectName );
+      const std::string *objectName;
+      total += base::read( file, *names, objectName );
       objectNames.push_back( objectName );
     }
 
@@ -0,0 +1,337 @@
+/*
+ * TerrainBenchmark.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "engine/engine.h"
+
+#include "ProceduralTerrainAppearance.h"
+#include "TerrainGenerator.h"
+#include "TerrainChunk.h"
+#include "TerrainProfiler.h"
+#include "TerrainSample.h"
+#include "Random.h"
+
+#include <stdio.h>
+
+/**
+ * Measures the terrain code on real planets:
+ *
+ * terrainbenchmark [-seed n] [-points n] [-grids n] [-layers n] [-profile] file.trn...
+ *
+ * Every planet gets the same sequence of random points for a given seed, so
+ * results can be compared across commits on the same machine.
+ */
+
+class BenchmarkSettings {
+public:
+	int seed;
+
+	// random points for getHeight and the per layer breakdown
+	int points;
+	int layerPoints;
+
+	// 64 x 64 sample grids at 2 m
+	int grids;
+
+	// per rule report over layerPoints full samples
+	bool profile;
+
+	BenchmarkSettings() {
+		seed = 1234;
+		points = 200000;
+		layerPoints = 20000;
+		grids = 64;
+		profile = false;
+	}
+};
+
+class LayerTime {
+public:
+	Layer* layer;
+	uint64 nanos;
+};
+
+static float nextCoordinate(trn::ptat::Random& random, float size) {
+	return ((float) random.next() / 2147483647.0f - 0.5f) * size;
+}
+
+static double seconds(uint64 nanos) {
+	return nanos / 1000000000.0;
+}
+
+static ProceduralTerrainAppearance* loadTerrain(const char* fileName) {
+	FILE* file = fopen(fileName, "rb");
+
+	if (file == NULL)
+		return NULL;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	byte* data = new byte[size];
+
+	bool read = size > 0 && fread(data, size, 1, file) == 1;
+
+	fclose(file);
+
+	if (!read) {
+		delete [] data;
+		return NULL;
+	}
+
+	// the same way Core3 opens its templates
+	IffStream* iffStream = new IffStream();
+
+	ProceduralTerrainAppearance* terrain = NULL;
+
+	try {
+		iffStream->parseChunks(data, fileName);
+
+		terrain = new ProceduralTerrainAppearance(NULL);
+		terrain->load(iffStream);
+	} catch (Exception& e) {
+		delete terrain;
+		terrain = NULL;
+	}
+
+	delete iffStream;
+	delete [] data;
+
+	return terrain;
+}
+
+static void benchmarkHeights(ProceduralTerrainAppearance* terrain, BenchmarkSettings& settings) {
+	float size = terrain->getSize();
+
+	trn::ptat::Random random;
+	random.setSeed(settings.seed);
+
+	float* x = new float[settings.points];
+	float* y = new float[settings.points];
+
+	for (int i = 0; i < settings.points; ++i) {
+		x[i] = nextCoordinate(random, size);
+		y[i] = nextCoordinate(random, size);
+	}
+
+	// keeps the calls from being optimized out
+	double checksum = 0;
+
+	uint64 start = Time::currentNanoTime();
+
+	for (int i = 0; i < settings.points; ++i)
+		checksum += terrain->getHeight(x[i], y[i]);
+
+	uint64 nanos = Time::currentNanoTime() - start;
+
+	printf("  getHeight     %9d points %8.3f s %10.0f points/s  checksum %.3f\n", settings.points, seconds(nanos), settings.points / seconds(nanos), checksum);
+
+	delete [] x;
+	delete [] y;
+}
+
+static void benchmarkGrids(ProceduralTerrainAppearance* terrain, BenchmarkSettings& settings) {
+	const int side = 64;
+	const float spacing = 2;
+
+	float size = terrain->getSize();
+
+	trn::ptat::Random random;
+	random.setSeed(settings.seed + 1);
+
+	float* heights = new float[side * side];
+
+	double checksum = 0;
+	uint64 nanos = 0;
+
+	for (int i = 0; i < settings.grids; ++i) {
+		float originX = nextCoordinate(random, size - side * spacing);
+		float originY = nextCoordinate(random, size - side * spacing);
+
+		uint64 start = Time::currentNanoTime();
+
+		terrain->sampleHeights(originX, originY, spacing, side, side, heights);
+
+		nanos += Time::currentNanoTime() - start;
+
+		for (int k = 0; k < side * side; ++k)
+			checksum += heights[k];
+	}
+
+	int samples = settings.grids * side * side;
+
+	printf("  sampleHeights %9d points %8.3f s %10.0f points/s  checksum %.3f\n", samples, seconds(nanos), samples / seconds(nanos), checksum);
+
+	delete [] heights;
+}
+
+static void benchmarkChunks(ProceduralTerrainAppearance* terrain, BenchmarkSettings& settings) {
+	// a 1 km square around the origin in 64 m chunks of 32 x 32 samples
+	const float area = 1024;
+	const float chunkSize = 64;
+	const int samples = 32;
+
+	uint64 start = Time::currentNanoTime();
+
+	Vector<TerrainChunk*>* chunks = terrain->generateTerrainChunks(-area / 2, -area / 2, area, chunkSize / samples, samples, samples, chunkSize);
+
+	uint64 nanos = Time::currentNanoTime() - start;
+
+	double checksum = 0;
+
+	for (int i = 0; i < chunks->size(); ++i) {
+		TerrainChunk* chunk = chunks->get(i);
+
+		for (int k = 0; k < samples * samples; ++k)
+			checksum += chunk->getHeightData()[k];
+
+		delete chunk;
+	}
+
+	printf("  chunks        %9d chunks %8.3f s %10.0f chunks/s  checksum %.3f\n", chunks->size(), seconds(nanos), chunks->size() / seconds(nanos), checksum);
+
+	delete chunks;
+}
+
+static void benchmarkLayers(ProceduralTerrainAppearance* terrain, BenchmarkSettings& settings) {
+	float size = terrain->getSize();
+
+	trn::ptat::Random random;
+	random.setSeed(settings.seed + 2);
+
+	float* x = new float[settings.layerPoints];
+	float* y = new float[settings.layerPoints];
+
+	for (int i = 0; i < settings.layerPoints; ++i) {
+		x[i] = nextCoordinate(random, size);
+		y[i] = nextCoordinate(random, size);
+	}
+
+	static const int affectorTypes[] = { AffectorProceduralRule::HEIGHTTYPE, AffectorProceduralRule::ENVIRONMENT, AffectorProceduralRule::SHADER };
+	static const char* affectorNames[] = { "height", "environment", "shader" };
+
+	Vector<Layer*>* layers = terrain->getTerrainGenerator()->getLayersGroup()->getLayers();
+
+	for (int type = 0; type < 3; ++type) {
+		Vector<LayerTime> times;
+		uint64 total = 0;
+
+		for (int i = 0; i < layers->size(); ++i) {
+			Layer* layer = layers->get(i);
+
+			if (!layer->isEnabled())
+				continue;
+
+			uint64 start = Time::currentNanoTime();
+
+			// every point starts from 0, not from what the previous one left
+			for (int k = 0; k < settings.layerPoints; ++k) {
+				float baseValue = 0;
+
+				terrain->processLayer(layer, x[k], y[k], baseValue, affectorTypes[type]);
+			}
+
+			LayerTime time;
+			time.layer = layer;
+			time.nanos = Time::currentNanoTime() - start;
+
+			total += time.nanos;
+
+			// slowest first
+			int position = 0;
+
+			while (position < times.size() && times.get(position).nanos >= time.nanos)
+				++position;
+
+			times.add(position, time);
+		}
+
+		printf("  %s layers, %.1f us per point over %d layers:\n", affectorNames[type], total / 1000.0 / settings.layerPoints, times.size());
+
+		for (int i = 0; i < times.size() && i < 10; ++i) {
+			LayerTime& time = times.get(i);
+
+			printf("    %6.2f%% %8.2f us  %s\n", total == 0 ? 0 : 100.0 * time.nanos / total, time.nanos / 1000.0 / settings.layerPoints, time.layer->getDescription().toCharArray());
+		}
+	}
+
+	delete [] x;
+	delete [] y;
+}
+
+static void benchmarkRules(ProceduralTerrainAppearance* terrain, BenchmarkSettings& settings) {
+	float size = terrain->getSize();
+
+	trn::ptat::Random random;
+	random.setSeed(settings.seed + 3);
+
+	terrain->enableProfiler();
+
+	TerrainSample sample;
+
+	for (int i = 0; i < settings.layerPoints; ++i) {
+		float x = nextCoordinate(random, size);
+		float y = nextCoordinate(random, size);
+
+		terrain->getSample(x, y, sample);
+	}
+
+	printf("  rules over %d samples:\n", settings.layerPoints);
+
+	terrain->getProfiler()->printReport(40);
+
+	terrain->disableProfiler();
+}
+
+int main(int argc, char** argv) {
+	BenchmarkSettings settings;
+
+	int files = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		String argument = argv[i];
+
+		if (i + 1 < argc && argument == "-seed")
+			settings.seed = atoi(argv[++i]);
+		else if (i + 1 < argc && argument == "-points")
+			settings.points = atoi(argv[++i]);
+		else if (i + 1 < argc && argument == "-grids")
+			settings.grids = atoi(argv[++i]);
+		else if (i + 1 < argc && argument == "-layers")
+			settings.layerPoints = atoi(argv[++i]);
+		else if (argument == "-profile")
+			settings.profile = true;
+		else {
+			++files;
+
+			ProceduralTerrainAppearance* terrain = loadTerrain(argv[i]);
+
+			if (terrain == NULL) {
+				printf("%s: could not load\n", argv[i]);
+				continue;
+			}
+
+			printf("%s: %.0f m, seed %d\n", argv[i], terrain->getSize(), settings.seed);
+
+			benchmarkHeights(terrain, settings);
+			benchmarkGrids(terrain, settings);
+			benchmarkChunks(terrain, settings);
+			benchmarkLayers(terrain, settings);
+
+			if (settings.profile)
+				benchmarkRules(terrain, settings);
+
+			delete terrain;
+		}
+	}
+
+	if (files == 0) {
+		printf("usage: %s [-seed n] [-points n] [-grids n] [-layers n] [-profile] file.trn...\n", argv[0]);
+		return 1;
+	}
+
+	return 0;
+}
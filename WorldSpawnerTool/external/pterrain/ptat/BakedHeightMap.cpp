@@ -0,0 +1,229 @@
+/*
+ * BakedHeightMap.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "BakedHeightMap.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+BakedHeightMap::BakedHeightMap() {
+	data = NULL;
+	dataSize = 0;
+
+	header = NULL;
+	levels = NULL;
+	tiles = NULL;
+
+	tileShift = 0;
+
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#else
+	fileDescriptor = -1;
+#endif
+}
+
+BakedHeightMap::~BakedHeightMap() {
+	close();
+}
+
+bool BakedHeightMap::open(const String& fileName) {
+	close();
+
+#ifdef _WIN32
+	fileHandle = CreateFileA(fileName.toCharArray(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(fileHandle, &size)) {
+		close();
+		return false;
+	}
+
+	dataSize = size.QuadPart;
+
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (mappingHandle == NULL) {
+		close();
+		return false;
+	}
+
+	data = (const uint8*) MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+	if (data == NULL) {
+		close();
+		return false;
+	}
+#else
+	fileDescriptor = ::open(fileName.toCharArray(), O_RDONLY);
+
+	if (fileDescriptor < 0)
+		return false;
+
+	struct stat status;
+
+	if (fstat(fileDescriptor, &status) != 0 || status.st_size < (off_t) sizeof(BakedHeightMapHeader)) {
+		close();
+		return false;
+	}
+
+	dataSize = status.st_size;
+
+	void* mapping = mmap(NULL, dataSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+	if (mapping == MAP_FAILED) {
+		close();
+		return false;
+	}
+
+	data = (const uint8*) mapping;
+
+	// lookups jump around the file
+	madvise(mapping, dataSize, MADV_RANDOM);
+#endif
+
+	const BakedHeightMapHeader* mapped = (const BakedHeightMapHeader*) data;
+
+	if (dataSize < sizeof(BakedHeightMapHeader) || mapped->magic != BakedHeightMapHeader::MAGIC || mapped->version != BakedHeightMapHeader::VERSION
+			|| mapped->levels < 1 || mapped->levels > 32 || mapped->tileSize < 1 || (mapped->tileSize & (mapped->tileSize - 1)) != 0) {
+		close();
+		return false;
+	}
+
+	uint64 tablesSize = sizeof(BakedHeightMapHeader) + mapped->levels * sizeof(BakedHeightMapLevel) + (uint64) mapped->tileCount * sizeof(BakedHeightMapTile);
+
+	if (mapped->tileCount < 1 || tablesSize > dataSize) {
+		close();
+		return false;
+	}
+
+	levels = (const BakedHeightMapLevel*) (data + sizeof(BakedHeightMapHeader));
+	tiles = (const BakedHeightMapTile*) (levels + mapped->levels);
+
+	for (int i = 0; i < mapped->levels; ++i) {
+		const BakedHeightMapLevel* level = &levels[i];
+
+		if (level->cells < 1 || level->firstTile < 0 || level->firstTile + level->tilesPerSide * level->tilesPerSide > mapped->tileCount
+				|| (level->cells + mapped->tileSize - 1) / mapped->tileSize != level->tilesPerSide) {
+			close();
+			return false;
+		}
+
+		inverseSpacing[i] = 1.0f / level->spacing;
+	}
+
+	uint64 tileDataSize = (uint64) (mapped->tileSize + 1) * (mapped->tileSize + 1) * sizeof(uint16);
+
+	for (int i = 0; i < mapped->tileCount; ++i) {
+		uint64 offset = tiles[i].offset;
+
+		if (offset != 0 && (offset < tablesSize || offset + tileDataSize > dataSize)) {
+			close();
+			return false;
+		}
+	}
+
+	tileShift = 0;
+
+	while ((1 << tileShift) < mapped->tileSize)
+		++tileShift;
+
+	header = mapped;
+
+	return true;
+}
+
+void BakedHeightMap::close() {
+#ifdef _WIN32
+	if (data != NULL)
+		UnmapViewOfFile(data);
+
+	if (mappingHandle != NULL)
+		CloseHandle(mappingHandle);
+
+	if (fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(fileHandle);
+
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#else
+	if (data != NULL)
+		munmap((void*) data, dataSize);
+
+	if (fileDescriptor >= 0)
+		::close(fileDescriptor);
+
+	fileDescriptor = -1;
+#endif
+
+	data = NULL;
+	dataSize = 0;
+
+	header = NULL;
+	levels = NULL;
+	tiles = NULL;
+}
+
+bool BakedHeightMap::getHeightRange(float minX, float minY, float maxX, float maxY, int level, float& minHeight, float& maxHeight) {
+	if (header == NULL)
+		return false;
+
+	const BakedHeightMapLevel* current = &levels[level];
+
+	float tileLength = current->spacing * header->tileSize;
+
+	int firstColumn = (int) ((minX - header->originX) / tileLength);
+	int lastColumn = (int) ((maxX - header->originX) / tileLength);
+	int firstRow = (int) ((minY - header->originY) / tileLength);
+	int lastRow = (int) ((maxY - header->originY) / tileLength);
+
+	int last = current->tilesPerSide - 1;
+
+	firstColumn = firstColumn < 0 ? 0 : (firstColumn > last ? last : firstColumn);
+	lastColumn = lastColumn < 0 ? 0 : (lastColumn > last ? last : lastColumn);
+	firstRow = firstRow < 0 ? 0 : (firstRow > last ? last : firstRow);
+	lastRow = lastRow < 0 ? 0 : (lastRow > last ? last : lastRow);
+
+	minHeight = tiles[current->firstTile + firstRow * current->tilesPerSide + firstColumn].minHeight;
+	maxHeight = minHeight;
+
+	for (int row = firstRow; row <= lastRow; ++row) {
+		for (int column = firstColumn; column <= lastColumn; ++column) {
+			const BakedHeightMapTile* tile = &tiles[current->firstTile + row * current->tilesPerSide + column];
+
+			if (tile->minHeight < minHeight)
+				minHeight = tile->minHeight;
+
+			if (tile->maxHeight > maxHeight)
+				maxHeight = tile->maxHeight;
+		}
+	}
+
+	return true;
+}
+
+int BakedHeightMap::getLevel(float spacing) {
+	if (header == NULL)
+		return 0;
+
+	for (int i = 0; i < header->levels; ++i) {
+		if (levels[i].spacing >= spacing)
+			return i;
+	}
+
+	return header->levels - 1;
+}
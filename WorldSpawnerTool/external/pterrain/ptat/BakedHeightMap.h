@@ -0,0 +1,198 @@
+/*
+ * BakedHeightMap.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef BAKEDHEIGHTMAP_H_
+#define BAKEDHEIGHTMAP_H_
+
+#include "engine/engine.h"
+
+/**
+ * File layout written by HeightMapBaker, all little endian:
+ *
+ * BakedHeightMapHeader
+ * BakedHeightMapLevel[levels], finest first
+ * BakedHeightMapTile[] of every level, row by row
+ * tile data
+ *
+ * Level l samples the terrain every spacing * 2^l meters starting at the
+ * origin, in tiles of tileSize x tileSize cells. Tiles keep the samples of
+ * their last row and column too, so a bilinear lookup never leaves its tile.
+ * A tile's samples are stored as (tileSize + 1)^2 uint16 between base and
+ * base + 65535 * scale, a tile of a single height stores no data at all.
+ */
+class BakedHeightMapHeader {
+public:
+	const static uint32 MAGIC = 0x504D4842; // "BHMP"
+	const static uint32 VERSION = 1;
+
+	uint32 magic;
+	uint32 version;
+
+	float originX, originY;
+
+	// of the finest level
+	float spacing;
+
+	int32 tileSize;
+	int32 levels;
+	int32 tileCount;
+};
+
+class BakedHeightMapLevel {
+public:
+	float spacing;
+
+	// cells per side, samples per side is one more
+	int32 cells;
+
+	int32 tilesPerSide;
+
+	// index of the level's first tile in the tile table
+	int32 firstTile;
+};
+
+class BakedHeightMapTile {
+public:
+	// range of the terrain under the tile, finer levels included
+	float minHeight, maxHeight;
+
+	float base, scale;
+
+	// from the start of the file, 0 for a tile of a single height
+	uint64 offset;
+};
+
+/**
+ * Read only view of a baked heightmap. The file is mapped, nothing is
+ * loaded up front and pages are only read in as lookups touch them.
+ */
+class BakedHeightMap {
+	const uint8* data;
+	uint64 dataSize;
+
+	const BakedHeightMapHeader* header;
+	const BakedHeightMapLevel* levels;
+	const BakedHeightMapTile* tiles;
+
+	// per level
+	float inverseSpacing[32];
+
+	int tileShift;
+
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+
+public:
+	BakedHeightMap();
+	~BakedHeightMap();
+
+	/**
+	 * Maps fileName, returns false when it can't be read or isn't a baked heightmap.
+	 */
+	bool open(const String& fileName);
+
+	void close();
+
+	inline bool isOpen() {
+		return header != NULL;
+	}
+
+	/**
+	 * Bilinear height at x, y on the given level, points off the map
+	 * get the height of its nearest edge.
+	 */
+	inline float getHeight(float x, float y, int level = 0) {
+		const BakedHeightMapLevel* current = &levels[level];
+
+		float fx = (x - header->originX) * inverseSpacing[level];
+		float fy = (y - header->originY) * inverseSpacing[level];
+
+		int lastCell = current->cells - 1;
+
+		// written so NaN ends up at 0 too
+		if (!(fx > 0))
+			fx = 0;
+		else if (fx > current->cells)
+			fx = (float) current->cells;
+
+		if (!(fy > 0))
+			fy = 0;
+		else if (fy > current->cells)
+			fy = (float) current->cells;
+
+		int column = (int) fx;
+		int row = (int) fy;
+
+		if (column > lastCell)
+			column = lastCell;
+
+		if (row > lastCell)
+			row = lastCell;
+
+		float u = fx - column;
+		float v = fy - row;
+
+		int mask = header->tileSize - 1;
+
+		const BakedHeightMapTile* tile = &tiles[current->firstTile + (row >> tileShift) * current->tilesPerSide + (column >> tileShift)];
+
+		if (tile->offset == 0)
+			return tile->base;
+
+		int stride = header->tileSize + 1;
+
+		const uint16* samples = (const uint16*) (data + tile->offset) + (row & mask) * stride + (column & mask);
+
+		float top = samples[0] + (samples[1] - (float) samples[0]) * u;
+		float bottom = samples[stride] + (samples[stride + 1] - (float) samples[stride]) * u;
+
+		return tile->base + (top + (bottom - top) * v) * tile->scale;
+	}
+
+	/**
+	 * Height bounds of the tiles of a level touching the box, false when the map isn't open.
+	 */
+	bool getHeightRange(float minX, float minY, float maxX, float maxY, int level, float& minHeight, float& maxHeight);
+
+	/**
+	 * Finest level whose spacing is at least the given one.
+	 */
+	int getLevel(float spacing);
+
+	inline int getLevelCount() {
+		return header->levels;
+	}
+
+	inline const BakedHeightMapLevel* getLevelInfo(int level) {
+		return &levels[level];
+	}
+
+	inline const BakedHeightMapTile* getTile(int level, int tileRow, int tileColumn) {
+		const BakedHeightMapLevel* current = &levels[level];
+
+		return &tiles[current->firstTile + tileRow * current->tilesPerSide + tileColumn];
+	}
+
+	/**
+	 * The (tileSize + 1)^2 quantized samples of a tile, NULL for a flat one.
+	 */
+	inline const uint16* getTileData(const BakedHeightMapTile* tile) {
+		if (tile->offset == 0)
+			return NULL;
+
+		return (const uint16*) (data + tile->offset);
+	}
+
+	inline const BakedHeightMapHeader* getHeader() {
+		return header;
+	}
+};
+
+#endif /* BAKEDHEIGHTMAP_H_ */
@@ -37,6 +37,14 @@ public:
 		iffStream->closeChunk('DATA');
 	}
 
+	inline int getID() {
+		return environmentId;
+	}
+
+	String getEnvironmentName() {
+		return environmentName;
+	}
+
 };
 
 #endif /* ENVIRONMENTDATA_H_ */
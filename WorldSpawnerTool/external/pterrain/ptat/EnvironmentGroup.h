@@ -13,10 +13,13 @@
 class EnvironmentGroup : public TemplateVariable<'EGRP'> {
 	Vector<EnvironmentData*> data;
 
+	// environments by id
+	HashTable<int, EnvironmentData*> environments;
+
 public:
 
 	EnvironmentGroup() {
-
+		environments.setNullValue(NULL);
 	}
 
 	~EnvironmentGroup() {
@@ -49,9 +52,20 @@ public:
 			efamData->readObject(iffStream);
 
 			data.add(efamData);
+
+			if (!environments.containsKey(efamData->getID()))
+				environments.put(efamData->getID(), efamData);
 		}
 
 	}
+
+	Vector<EnvironmentData*>* getEnvironments() {
+		return &data;
+	}
+
+	inline EnvironmentData* getEnvironment(int environmentId) {
+		return environments.get(environmentId);
+	}
 };
 
 
@@ -71,6 +71,27 @@ public:
 
 		iffStream->closeChunk('FFAM');
 	}
+
+	inline int getID() {
+		return familyId;
+	}
+
+	String getFamilyName() {
+		return familyName;
+	}
+
+	// chance of a tile holding a plant of this family
+	inline float getWeight() {
+		return weight;
+	}
+
+	inline bool isAquaticFamily() {
+		return isAquatic != 0;
+	}
+
+	Vector<FloraData*>* getFloraData() {
+		return &data;
+	}
 };
 
 
@@ -14,7 +14,14 @@
 
 class FloraGroup : public TemplateVariable<'FGRP'> {
 	Vector<FloraFamily*> data;
+
+	// flora families by id
+	HashTable<int, FloraFamily*> families;
+
 public:
+	FloraGroup() {
+		families.setNullValue(NULL);
+	}
 
 	~FloraGroup() {
 		while (data.size() > 0)
@@ -46,8 +53,19 @@ public:
 			ffam->readObject(iffStream);
 
 			data.add(ffam);
+
+			if (!families.containsKey(ffam->getID()))
+				families.put(ffam->getID(), ffam);
 		}
 	}
+
+	Vector<FloraFamily*>* getFloraFamilies() {
+		return &data;
+	}
+
+	inline FloraFamily* getFloraFamily(int familyId) {
+		return families.get(familyId);
+	}
 };
 
 
@@ -0,0 +1,50 @@
+/*
+ * FractalNoiseMemo.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "FractalNoiseMemo.h"
+
+#include <pthread.h>
+
+/**
+ * The memo of each thread. Unlike ThreadLocal the key has a destructor, so
+ * every thread frees its memo when it ends, whether a pool started it or not.
+ */
+class ThreadMemos {
+	pthread_key_t key;
+
+public:
+	ThreadMemos() {
+		pthread_key_create(&key, deleteMemo);
+	}
+
+	// the key outlives this so threads ending during exit still free theirs
+
+	inline FractalNoiseMemo* get() {
+		return (FractalNoiseMemo*) pthread_getspecific(key);
+	}
+
+	inline void set(FractalNoiseMemo* memo) {
+		pthread_setspecific(key, memo);
+	}
+
+	static void deleteMemo(void* memo) {
+		delete (FractalNoiseMemo*) memo;
+	}
+};
+
+static ThreadMemos threadMemos;
+
+FractalNoiseMemo* FractalNoiseMemo::getThreadMemo() {
+	FractalNoiseMemo* memo = threadMemos.get();
+
+	if (memo == NULL) {
+		memo = new FractalNoiseMemo();
+
+		threadMemos.set(memo);
+	}
+
+	return memo;
+}
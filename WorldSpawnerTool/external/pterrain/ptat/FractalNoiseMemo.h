@@ -0,0 +1,110 @@
+/*
+ * FractalNoiseMemo.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef FRACTALNOISEMEMO_H_
+#define FRACTALNOISEMEMO_H_
+
+#include "engine/engine.h"
+
+/**
+ * Recently computed fractal noise of the calling thread, so rules sharing a
+ * MapFractal don't run all its octaves again at the same point. Entries are
+ * keyed by MapFractal::getMemoKey() and the exact coordinates, a direct mapped
+ * table where a colliding entry simply replaces the older one.
+ */
+class FractalNoiseMemo {
+	class Entry {
+	public:
+		uint32 key;
+		uint32 x, y;
+		float value;
+	};
+
+	Entry* entries;
+
+	uint64 hits;
+	uint64 misses;
+
+public:
+	// entries per thread, 16 bytes each
+	const static int SIZE = 4096;
+
+	FractalNoiseMemo() {
+		entries = new Entry[SIZE];
+
+		// keys start at 1, 0 marks an empty entry
+		memset(entries, 0, SIZE * sizeof(Entry));
+
+		hits = 0;
+		misses = 0;
+	}
+
+	~FractalNoiseMemo() {
+		delete [] entries;
+	}
+
+	inline bool find(uint32 key, float x, float y, float& value) {
+		uint32 bitsX = toBits(x), bitsY = toBits(y);
+
+		Entry* entry = &entries[getSlot(key, bitsX, bitsY)];
+
+		if (entry->key != key || entry->x != bitsX || entry->y != bitsY) {
+			++misses;
+			return false;
+		}
+
+		++hits;
+
+		value = entry->value;
+
+		return true;
+	}
+
+	inline void store(uint32 key, float x, float y, float value) {
+		uint32 bitsX = toBits(x), bitsY = toBits(y);
+
+		Entry* entry = &entries[getSlot(key, bitsX, bitsY)];
+
+		entry->key = key;
+		entry->x = bitsX;
+		entry->y = bitsY;
+		entry->value = value;
+	}
+
+	inline uint64 getHits() {
+		return hits;
+	}
+
+	inline uint64 getMisses() {
+		return misses;
+	}
+
+	/**
+	 * The calling thread's memo, created on first use and freed when the
+	 * thread ends.
+	 */
+	static FractalNoiseMemo* getThreadMemo();
+
+protected:
+	static inline uint32 toBits(float value) {
+		union {
+			float f;
+			uint32 u;
+		} bits;
+
+		bits.f = value;
+
+		return bits.u;
+	}
+
+	static inline int getSlot(uint32 key, uint32 x, uint32 y) {
+		uint32 hash = x * 0x9E3779B1u ^ y * 0x85EBCA77u ^ key * 0xC2B2AE3Du;
+
+		return (hash ^ (hash >> 15)) & (SIZE - 1);
+	}
+};
+
+#endif /* FRACTALNOISEMEMO_H_ */
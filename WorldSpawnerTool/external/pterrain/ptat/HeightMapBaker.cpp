@@ -0,0 +1,303 @@
+/*
+ * HeightMapBaker.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "HeightMapBaker.h"
+#include "ProceduralTerrainAppearance.h"
+#include "TerrainWorkerPool.h"
+
+#include <stdio.h>
+
+class HeightMapTileTask : public TerrainTask {
+	HeightMapBaker* baker;
+	const BakedHeightMapHeader* header;
+	const BakedHeightMapLevel* level;
+	int tileRow;
+
+	int samplesPerTile;
+
+public:
+	BakedHeightMapTile* tiles;
+	uint16* data;
+	bool* hasData;
+
+	// tiles to sample, the others are left alone
+	bool* dirty;
+
+	HeightMapTileTask(HeightMapBaker* baker, const BakedHeightMapHeader* header, const BakedHeightMapLevel* level, int tileRow) {
+		this->baker = baker;
+		this->header = header;
+		this->level = level;
+		this->tileRow = tileRow;
+
+		samplesPerTile = (header->tileSize + 1) * (header->tileSize + 1);
+
+		tiles = new BakedHeightMapTile[level->tilesPerSide];
+		data = new uint16[level->tilesPerSide * samplesPerTile];
+		hasData = new bool[level->tilesPerSide];
+		dirty = new bool[level->tilesPerSide];
+	}
+
+	~HeightMapTileTask() {
+		delete [] tiles;
+		delete [] data;
+		delete [] hasData;
+		delete [] dirty;
+	}
+
+	void run(int index) {
+		if (!dirty[index])
+			return;
+
+		float* samples = new float[samplesPerTile];
+
+		baker->sampleTile(header, level, tileRow, index, samples);
+
+		hasData[index] = HeightMapBaker::compressTile(samples, samplesPerTile, &tiles[index], data + index * samplesPerTile);
+
+		delete [] samples;
+	}
+};
+
+HeightMapBaker::HeightMapBaker(ProceduralTerrainAppearance* terrain) {
+	this->terrain = terrain;
+
+	spacing = 2;
+	tileSize = 64;
+	threads = 0;
+}
+
+void HeightMapBaker::sampleTile(const BakedHeightMapHeader* header, const BakedHeightMapLevel* level, int tileRow, int tileColumn, float* out) {
+	int samples = header->tileSize + 1;
+
+	float originX = header->originX + (float) tileColumn * header->tileSize * level->spacing;
+	float originY = header->originY + (float) tileRow * header->tileSize * level->spacing;
+
+	terrain->sampleHeights(originX, originY, level->spacing, samples, samples, out);
+}
+
+bool HeightMapBaker::compressTile(const float* samples, int count, BakedHeightMapTile* tile, uint16* data) {
+	float minHeight = samples[0], maxHeight = samples[0];
+
+	for (int i = 1; i < count; ++i) {
+		if (samples[i] < minHeight)
+			minHeight = samples[i];
+
+		if (samples[i] > maxHeight)
+			maxHeight = samples[i];
+	}
+
+	tile->minHeight = minHeight;
+	tile->maxHeight = maxHeight;
+	tile->base = minHeight;
+	tile->offset = 0;
+
+	if (!(maxHeight > minHeight)) {
+		tile->scale = 0;
+		return false;
+	}
+
+	tile->scale = (maxHeight - minHeight) / 65535;
+
+	float inverseScale = 65535 / (maxHeight - minHeight);
+
+	for (int i = 0; i < count; ++i) {
+		float quantized = (samples[i] - minHeight) * inverseScale + 0.5f;
+
+		data[i] = quantized >= 65535 ? 65535 : (uint16) quantized;
+	}
+
+	return true;
+}
+
+bool HeightMapBaker::bake(const String& fileName) {
+	return write(fileName, NULL, NULL);
+}
+
+bool HeightMapBaker::isCompatible(BakedHeightMap* map) {
+	const BakedHeightMapHeader* header = map->getHeader();
+
+	float size = terrain->getSize();
+
+	return header->spacing == spacing && header->tileSize == tileSize
+			&& header->originX == -size / 2 && header->originY == -size / 2;
+}
+
+bool HeightMapBaker::update(const String& fileName, const TerrainRegion& region) {
+	BakedHeightMap previous;
+
+	if (region.isEverywhere() || !previous.open(fileName) || !isCompatible(&previous))
+		return bake(fileName);
+
+	if (region.isEmpty())
+		return true;
+
+	// the old tiles are read from the map while the new file is written
+	String temporaryName = fileName + ".tmp";
+
+	TerrainRegion reach = terrain->getReach(region);
+
+	bool success = write(temporaryName, &previous, &reach);
+
+	previous.close();
+
+	if (!success)
+		return false;
+
+	remove(fileName.toCharArray());
+
+	return rename(temporaryName.toCharArray(), fileName.toCharArray()) == 0;
+}
+
+bool HeightMapBaker::write(const String& fileName, BakedHeightMap* previous, const TerrainRegion* region) {
+	if (!(spacing > 0) || tileSize < 1 || (tileSize & (tileSize - 1)) != 0)
+		return false;
+
+	float size = terrain->getSize();
+
+	if (!(size > 0))
+		return false;
+
+	BakedHeightMapHeader header;
+	header.magic = BakedHeightMapHeader::MAGIC;
+	header.version = BakedHeightMapHeader::VERSION;
+	header.originX = -size / 2;
+	header.originY = -size / 2;
+	header.spacing = spacing;
+	header.tileSize = tileSize;
+	header.levels = 0;
+	header.tileCount = 0;
+
+	Vector<BakedHeightMapLevel> levels;
+
+	// halve the resolution until one tile covers the planet
+	int cells = (int) ceil(size / spacing);
+
+	for (int shift = 0; shift < 32; ++shift) {
+		BakedHeightMapLevel level;
+		level.spacing = spacing * (1 << shift);
+		level.cells = (cells + (1 << shift) - 1) >> shift;
+		level.tilesPerSide = (level.cells + tileSize - 1) / tileSize;
+		level.firstTile = header.tileCount;
+
+		levels.add(level);
+
+		header.tileCount += level.tilesPerSide * level.tilesPerSide;
+
+		if (level.tilesPerSide == 1)
+			break;
+	}
+
+	header.levels = levels.size();
+
+	FILE* file = fopen(fileName.toCharArray(), "wb");
+
+	if (file == NULL)
+		return false;
+
+	BakedHeightMapTile* tiles = new BakedHeightMapTile[header.tileCount];
+
+	uint64 offset = sizeof(BakedHeightMapHeader) + header.levels * sizeof(BakedHeightMapLevel) + (uint64) header.tileCount * sizeof(BakedHeightMapTile);
+
+	// tables are written last, once the offsets are known
+	bool success = fseek(file, (long) offset, SEEK_SET) == 0;
+
+	uint64 tileDataSize = (uint64) (tileSize + 1) * (tileSize + 1) * sizeof(uint16);
+
+	TerrainWorkerPool pool(threads);
+
+	for (int i = 0; i < header.levels && success; ++i) {
+		BakedHeightMapLevel* level = &levels.get(i);
+
+		float tileExtent = tileSize * level->spacing;
+
+		for (int tileRow = 0; tileRow < level->tilesPerSide && success; ++tileRow) {
+			HeightMapTileTask task(this, &header, level, tileRow);
+
+			bool anyDirty = false;
+
+			for (int tileColumn = 0; tileColumn < level->tilesPerSide; ++tileColumn) {
+				float tileX = header.originX + tileColumn * tileExtent;
+				float tileY = header.originY + tileRow * tileExtent;
+
+				task.dirty[tileColumn] = previous == NULL || region->intersects(tileX, tileY, tileX + tileExtent, tileY + tileExtent);
+
+				anyDirty |= task.dirty[tileColumn];
+			}
+
+			if (anyDirty)
+				pool.execute(&task, level->tilesPerSide);
+
+			for (int tileColumn = 0; tileColumn < level->tilesPerSide; ++tileColumn) {
+				BakedHeightMapTile* tile = &tiles[level->firstTile + tileRow * level->tilesPerSide + tileColumn];
+
+				const uint16* tileData = NULL;
+
+				if (task.dirty[tileColumn]) {
+					*tile = task.tiles[tileColumn];
+
+					if (task.hasData[tileColumn])
+						tileData = task.data + tileColumn * (tileSize + 1) * (tileSize + 1);
+				} else {
+					const BakedHeightMapTile* previousTile = previous->getTile(i, tileRow, tileColumn);
+
+					*tile = *previousTile;
+					tile->offset = 0;
+
+					tileData = previous->getTileData(previousTile);
+				}
+
+				if (tileData != NULL) {
+					tile->offset = offset;
+					offset += tileDataSize;
+
+					if (fwrite(tileData, tileDataSize, 1, file) != 1) {
+						success = false;
+						break;
+					}
+				}
+
+				if (i == 0)
+					continue;
+
+				// the range also covers whatever the finer tiles below saw
+				BakedHeightMapLevel* finer = &levels.get(i - 1);
+
+				for (int row = tileRow * 2; row <= tileRow * 2 + 1 && row < finer->tilesPerSide; ++row) {
+					for (int column = tileColumn * 2; column <= tileColumn * 2 + 1 && column < finer->tilesPerSide; ++column) {
+						BakedHeightMapTile* child = &tiles[finer->firstTile + row * finer->tilesPerSide + column];
+
+						if (child->minHeight < tile->minHeight)
+							tile->minHeight = child->minHeight;
+
+						if (child->maxHeight > tile->maxHeight)
+							tile->maxHeight = child->maxHeight;
+					}
+				}
+			}
+		}
+	}
+
+	if (success) {
+		success = fseek(file, 0, SEEK_SET) == 0
+				&& fwrite(&header, sizeof(header), 1, file) == 1;
+
+		for (int i = 0; i < levels.size() && success; ++i)
+			success = fwrite(&levels.get(i), sizeof(BakedHeightMapLevel), 1, file) == 1;
+
+		if (success)
+			success = fwrite(tiles, sizeof(BakedHeightMapTile), header.tileCount, file) == (size_t) header.tileCount;
+	}
+
+	delete [] tiles;
+
+	if (fclose(file) != 0)
+		success = false;
+
+	if (!success)
+		remove(fileName.toCharArray());
+
+	return success;
+}
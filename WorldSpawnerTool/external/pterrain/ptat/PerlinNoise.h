@@ -11,6 +11,17 @@
 /* coherent noise function over 1, 2 or 3 dimensions */
 /* (copyright Ken Perlin) */
 
+/* widest instruction set enabled at compile time, before the one letter macros below */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PERLIN_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PERLIN_SIMD_WIDTH 4
+#else
+#define PERLIN_SIMD_WIDTH 1
+#endif
+
 #define B 0x100
 #define BM 0xff
 
@@ -100,6 +111,110 @@ public:
 		return lerp(sy, a, b);
 	}
 
+	/**
+	 * noise2 for PERLIN_SIMD_WIDTH points at once, in single precision.
+	 * Lattice cells are picked exactly like noise2 does, only the
+	 * interpolation differs in rounding (below 1e-6 per call).
+	 */
+	void noise2(const float* x, const float* y, float* out) {
+		if (start) {
+			start = 0;
+			init();
+		}
+
+#if PERLIN_SIMD_WIDTH == 8
+		__m256 vx = _mm256_loadu_ps(x);
+		__m256 vy = _mm256_loadu_ps(y);
+
+		__m256i bx0, bx1, by0, by1;
+		__m256 rx0, rx1, ry0, ry1;
+
+		setup8(vx, bx0, bx1, rx0, rx1);
+		setup8(vy, by0, by1, ry0, ry1);
+
+		__m256i i = _mm256_i32gather_epi32(p, bx0, 4);
+		__m256i j = _mm256_i32gather_epi32(p, bx1, 4);
+
+		__m256i b00 = _mm256_i32gather_epi32(p, _mm256_add_epi32(i, by0), 4);
+		__m256i b10 = _mm256_i32gather_epi32(p, _mm256_add_epi32(j, by0), 4);
+		__m256i b01 = _mm256_i32gather_epi32(p, _mm256_add_epi32(i, by1), 4);
+		__m256i b11 = _mm256_i32gather_epi32(p, _mm256_add_epi32(j, by1), 4);
+
+		__m256 three = _mm256_set1_ps(3.f);
+		__m256 sx = _mm256_mul_ps(_mm256_mul_ps(rx0, rx0), _mm256_sub_ps(three, _mm256_add_ps(rx0, rx0)));
+		__m256 sy = _mm256_mul_ps(_mm256_mul_ps(ry0, ry0), _mm256_sub_ps(three, _mm256_add_ps(ry0, ry0)));
+
+		__m256 u = at8(b00, rx0, ry0);
+		__m256 v = at8(b10, rx1, ry0);
+		__m256 a = _mm256_add_ps(u, _mm256_mul_ps(sx, _mm256_sub_ps(v, u)));
+
+		u = at8(b01, rx0, ry1);
+		v = at8(b11, rx1, ry1);
+		__m256 b = _mm256_add_ps(u, _mm256_mul_ps(sx, _mm256_sub_ps(v, u)));
+
+		_mm256_storeu_ps(out, _mm256_add_ps(a, _mm256_mul_ps(sy, _mm256_sub_ps(b, a))));
+#elif PERLIN_SIMD_WIDTH == 4
+		__m128 vx = _mm_loadu_ps(x);
+		__m128 vy = _mm_loadu_ps(y);
+
+		__m128i bx0, bx1, by0, by1;
+		__m128 rx0, rx1, ry0, ry1;
+
+		setup4(vx, bx0, bx1, rx0, rx1);
+		setup4(vy, by0, by1, ry0, ry1);
+
+		// no gather before AVX2, the table lookups are done one lane at a time
+		int ibx0[4], ibx1[4], iby0[4], iby1[4];
+		_mm_storeu_si128((__m128i*) ibx0, bx0);
+		_mm_storeu_si128((__m128i*) ibx1, bx1);
+		_mm_storeu_si128((__m128i*) iby0, by0);
+		_mm_storeu_si128((__m128i*) iby1, by1);
+
+		float q00[2][4], q10[2][4], q01[2][4], q11[2][4];
+
+		for (int k = 0; k < 4; ++k) {
+			int i = p[ibx0[k]];
+			int j = p[ibx1[k]];
+
+			const float* q = g2[p[i + iby0[k]]];
+			q00[0][k] = q[0];
+			q00[1][k] = q[1];
+
+			q = g2[p[j + iby0[k]]];
+			q10[0][k] = q[0];
+			q10[1][k] = q[1];
+
+			q = g2[p[i + iby1[k]]];
+			q01[0][k] = q[0];
+			q01[1][k] = q[1];
+
+			q = g2[p[j + iby1[k]]];
+			q11[0][k] = q[0];
+			q11[1][k] = q[1];
+		}
+
+		__m128 three = _mm_set1_ps(3.f);
+		__m128 sx = _mm_mul_ps(_mm_mul_ps(rx0, rx0), _mm_sub_ps(three, _mm_add_ps(rx0, rx0)));
+		__m128 sy = _mm_mul_ps(_mm_mul_ps(ry0, ry0), _mm_sub_ps(three, _mm_add_ps(ry0, ry0)));
+
+		__m128 u = at4(q00, rx0, ry0);
+		__m128 v = at4(q10, rx1, ry0);
+		__m128 a = _mm_add_ps(u, _mm_mul_ps(sx, _mm_sub_ps(v, u)));
+
+		u = at4(q01, rx0, ry1);
+		v = at4(q11, rx1, ry1);
+		__m128 b = _mm_add_ps(u, _mm_mul_ps(sx, _mm_sub_ps(v, u)));
+
+		_mm_storeu_ps(out, _mm_add_ps(a, _mm_mul_ps(sy, _mm_sub_ps(b, a))));
+#else
+		double vec[2];
+		vec[0] = x[0];
+		vec[1] = y[0];
+
+		out[0] = noise2(vec);
+#endif
+	}
+
 	static void normalize2(float v[2]) {
 		double s;
 
@@ -117,6 +232,53 @@ public:
 		v[2] = v[2] / s;
 	}
 
+#if PERLIN_SIMD_WIDTH == 8
+	/* same cells as setup: t = v + N truncated towards zero */
+	static inline void setup8(__m256 v, __m256i& b0, __m256i& b1, __m256& r0, __m256& r1) {
+		__m256 cell = _mm256_floor_ps(v);
+		__m256 below = _mm256_and_ps(_mm256_cmp_ps(v, _mm256_set1_ps(-N), _CMP_LT_OQ), _mm256_cmp_ps(v, cell, _CMP_NEQ_OQ));
+		cell = _mm256_add_ps(cell, _mm256_and_ps(below, _mm256_set1_ps(1.f)));
+
+		__m256i mask = _mm256_set1_epi32(BM);
+		b0 = _mm256_and_si256(_mm256_cvttps_epi32(cell), mask);
+		b1 = _mm256_and_si256(_mm256_add_epi32(b0, _mm256_set1_epi32(1)), mask);
+		r0 = _mm256_sub_ps(v, cell);
+		r1 = _mm256_sub_ps(r0, _mm256_set1_ps(1.f));
+	}
+
+	inline __m256 at8(__m256i b, __m256 rx, __m256 ry) {
+		__m256i index = _mm256_add_epi32(b, b);
+		__m256 qx = _mm256_i32gather_ps(&g2[0][0], index, 4);
+		__m256 qy = _mm256_i32gather_ps(&g2[0][1], index, 4);
+
+		return _mm256_add_ps(_mm256_mul_ps(rx, qx), _mm256_mul_ps(ry, qy));
+	}
+#elif PERLIN_SIMD_WIDTH == 4
+	/* same cells as setup: t = v + N truncated towards zero */
+	static inline void setup4(__m128 v, __m128i& b0, __m128i& b1, __m128& r0, __m128& r1) {
+		__m128i cell = _mm_cvttps_epi32(v);
+		__m128 cellf = _mm_cvtepi32_ps(cell);
+
+		// truncation rounded negative values up, step down to the floor
+		cell = _mm_add_epi32(cell, _mm_castps_si128(_mm_cmplt_ps(v, cellf)));
+		cellf = _mm_cvtepi32_ps(cell);
+
+		__m128 below = _mm_and_ps(_mm_cmplt_ps(v, _mm_set1_ps(-N)), _mm_cmpneq_ps(v, cellf));
+		cell = _mm_sub_epi32(cell, _mm_castps_si128(below));
+		cellf = _mm_cvtepi32_ps(cell);
+
+		__m128i mask = _mm_set1_epi32(BM);
+		b0 = _mm_and_si128(cell, mask);
+		b1 = _mm_and_si128(_mm_add_epi32(b0, _mm_set1_epi32(1)), mask);
+		r0 = _mm_sub_ps(v, cellf);
+		r1 = _mm_sub_ps(r0, _mm_set1_ps(1.f));
+	}
+
+	static inline __m128 at4(float q[2][4], __m128 rx, __m128 ry) {
+		return _mm_add_ps(_mm_mul_ps(rx, _mm_loadu_ps(q[0])), _mm_mul_ps(ry, _mm_loadu_ps(q[1])));
+	}
+#endif
+
 	void init() {
 		int i, j, k;
 
@@ -9,8 +9,66 @@
 #include "TerrainGenerator.h"
 #include "TerrainMaps.h"
 #include "layer/boundaries/Boundary.h"
+#include "layer/filters/FilterSlope.h"
 #include "PerlinNoise.h"
 #include "TerrainChunk.h"
+#include "TerrainGrid.h"
+#include "TerrainLayerIndex.h"
+#include "TerrainWaterIndex.h"
+#include "TerrainProgram.h"
+#include "TerrainSample.h"
+#include "TerrainHeightCache.h"
+#include "TerrainChunkPool.h"
+#include "TerrainWorkerPool.h"
+#include "TerrainProfiler.h"
+#include "TerrainNormals.h"
+#include "TerrainFloraIndex.h"
+#include "Random.h"
+
+class TerrainFloraTask : public TerrainTask {
+	ProceduralTerrainAppearance* terrain;
+	int firstColumn, firstRow;
+	int columns;
+
+	TerrainFloraPlacement* placements;
+	bool* planted;
+
+public:
+	TerrainFloraTask(ProceduralTerrainAppearance* terrain, int firstColumn, int firstRow, int columns, TerrainFloraPlacement* placements, bool* planted) {
+		this->terrain = terrain;
+		this->firstColumn = firstColumn;
+		this->firstRow = firstRow;
+		this->columns = columns;
+		this->placements = placements;
+		this->planted = planted;
+	}
+
+	// one row of tiles, each writes only its own slot
+	void run(int index) {
+		for (int column = 0; column < columns; ++column) {
+			int tile = index * columns + column;
+
+			planted[tile] = terrain->getCollidableFlora(firstColumn + column, firstRow + index, placements[tile]);
+		}
+	}
+};
+
+class TerrainChunkTask : public TerrainTask {
+	ProceduralTerrainAppearance* terrain;
+	Vector<TerrainChunk*>* chunks;
+	float distanceBetweenHeights;
+
+public:
+	TerrainChunkTask(ProceduralTerrainAppearance* terrain, Vector<TerrainChunk*>* chunks, float distanceBetweenHeights) {
+		this->terrain = terrain;
+		this->chunks = chunks;
+		this->distanceBetweenHeights = distanceBetweenHeights;
+	}
+
+	void run(int index) {
+		terrain->generateTerrainChunk(chunks->get(index), distanceBetweenHeights);
+	}
+};
 
 ProceduralTerrainAppearance::ProceduralTerrainAppearance(TerrainGenerator* terrainGenerator) : Logger("ProceduralTerrainAppearance") {
 	if (terrainGenerator == NULL)
@@ -18,8 +76,24 @@ ProceduralTerrainAppearance::ProceduralTerrainAppearance(TerrainGenerator* terra
 
 	this->terrainGenerator = terrainGenerator;
 	terrainMaps = new TerrainMaps();
+	layerIndex = new TerrainLayerIndex();
+	waterIndex = new TerrainWaterIndex();
 
 	useGlobalWaterTable = 0;
+
+	generationThreads = 0;
+
+	compiledLayers = false;
+
+	heightCache = NULL;
+
+	chunkPool = new TerrainChunkPool();
+
+	profiler = NULL;
+
+	slopeFilters = false;
+
+	slopeSpacing = 2;
 }
 
 ProceduralTerrainAppearance::~ProceduralTerrainAppearance() {
@@ -28,11 +102,33 @@ ProceduralTerrainAppearance::~ProceduralTerrainAppearance() {
 
 	delete terrainMaps;
 	terrainMaps = NULL;
+
+	delete layerIndex;
+	layerIndex = NULL;
+
+	delete waterIndex;
+	waterIndex = NULL;
+
+	releasePrograms();
+
+	delete heightCache;
+	heightCache = NULL;
+
+	delete chunkPool;
+	chunkPool = NULL;
+
+	delete profiler;
+	profiler = NULL;
 }
 
 bool ProceduralTerrainAppearance::load(IffStream* iffStream) {
 	waterBoundaries.removeAll();
 
+	layerIndex->clear();
+	waterIndex->clear();
+
+	releasePrograms();
+
 	delete terrainGenerator;
 	delete terrainMaps;
 
@@ -41,11 +137,113 @@ bool ProceduralTerrainAppearance::load(IffStream* iffStream) {
 
 	readObject(iffStream);
 
+	if (tilesPerChunk != 0 && chunkSize > 0)
+		slopeSpacing = chunkSize / tilesPerChunk;
+	else
+		slopeSpacing = 2;
+
 	terrainGenerator->processLayers();
 
+	layerIndex->build(terrainGenerator->getLayersGroup(), size);
+	waterIndex->build(&waterBoundaries, size);
+
+	slopeFilters = hasSlopeFilters(terrainGenerator->getLayersGroup()->getLayers());
+
+	if (compiledLayers)
+		compileLayers();
+
+	if (heightCache != NULL)
+		heightCache->clear();
+
+	if (profiler != NULL)
+		enableProfiler();
+
 	return true;
 }
 
+void ProceduralTerrainAppearance::enableHeightCache(float tileSize, int resolution, uint64 memoryCap) {
+	delete heightCache;
+
+	heightCache = new TerrainHeightCache(this, tileSize, resolution, memoryCap);
+}
+
+void ProceduralTerrainAppearance::disableHeightCache() {
+	delete heightCache;
+	heightCache = NULL;
+}
+
+void ProceduralTerrainAppearance::enableProfiler() {
+	delete profiler;
+
+	profiler = new TerrainProfiler(terrainGenerator);
+}
+
+void ProceduralTerrainAppearance::disableProfiler() {
+	delete profiler;
+	profiler = NULL;
+}
+
+void ProceduralTerrainAppearance::setCompiledLayers(bool enabled) {
+	compiledLayers = enabled;
+
+	if (enabled)
+		compileLayers();
+	else
+		releasePrograms();
+}
+
+void ProceduralTerrainAppearance::compileLayers() {
+	releasePrograms();
+
+	int affectorTypes[] = { AffectorProceduralRule::HEIGHTTYPE, AffectorProceduralRule::ENVIRONMENT,
+			AffectorProceduralRule::SHADER, AffectorProceduralRule::ALL };
+
+	for (int i = 0; i < 4; ++i) {
+		TerrainProgram* program = new TerrainProgram();
+
+		if (!program->compile(terrainGenerator->getLayersGroup(), affectorTypes[i])) {
+			error("layer tree too deep to compile, walking it instead");
+
+			delete program;
+			releasePrograms();
+
+			return;
+		}
+
+		programs.add(program);
+	}
+}
+
+bool ProceduralTerrainAppearance::hasSlopeFilters(Vector<Layer*>* layers) {
+	for (int i = 0; i < layers->size(); ++i) {
+		Layer* layer = layers->get(i);
+
+		if (!layer->isEnabled())
+			continue;
+
+		Vector<FilterProceduralRule*>* filters = layer->getFilters();
+
+		for (int k = 0; k < filters->size(); ++k) {
+			FilterProceduralRule* filter = filters->get(k);
+
+			if (filter->isEnabled() && dynamic_cast<FilterSlope*>(filter) != NULL)
+				return true;
+		}
+
+		if (hasSlopeFilters(layer->getChildren()))
+			return true;
+	}
+
+	return false;
+}
+
+void ProceduralTerrainAppearance::releasePrograms() {
+	for (int i = 0; i < programs.size(); ++i)
+		delete programs.get(i);
+
+	programs.removeAll();
+}
+
 void ProceduralTerrainAppearance::parseFromIffStream(engine::util::IffStream* iffStream) {
 	uint32 version = iffStream->getNextFormType();
 
@@ -112,14 +310,32 @@ void ProceduralTerrainAppearance::parseFromIffStream(engine::util::IffStream* if
 	terrainMaps->readObject(iffStream);
 }
 
-bool ProceduralTerrainAppearance::getWater(float x, float y, float& waterHeight) {
+void ProceduralTerrainAppearance::insertWaterBoundary(Boundary* boundary) {
+	waterBoundaries.add(boundary);
+
+	waterIndex->clear();
+}
+
+Boundary* ProceduralTerrainAppearance::getWaterBoundary(float x, float y) {
+	if (waterIndex->isBuilt())
+		return waterIndex->getBoundary(x, y);
+
 	for (int i = 0; i < waterBoundaries.size(); ++i) {
 		Boundary* boundary = waterBoundaries.get(i);
 
-		if (boundary->containsPoint(x, y)) {
-			waterHeight = boundary->getLocalWaterTableHeight();
-			return true;
-		}
+		if (boundary->containsPoint(x, y))
+			return boundary;
+	}
+
+	return NULL;
+}
+
+bool ProceduralTerrainAppearance::getWater(float x, float y, float& waterHeight) {
+	Boundary* boundary = getWaterBoundary(x, y);
+
+	if (boundary != NULL) {
+		waterHeight = boundary->getLocalWaterTableHeight();
+		return true;
 	}
 
 	if (useGlobalWaterTable != 0) {
@@ -130,9 +346,35 @@ bool ProceduralTerrainAppearance::getWater(float x, float y, float& waterHeight)
 	return false;
 }
 
-Layer* ProceduralTerrainAppearance::getLayerRecursive(float x, float y, Layer* rootParent) {
+int ProceduralTerrainAppearance::getWater(const float* x, const float* y, int count, float* waterHeight, bool* water) {
+	int wet = 0;
+
+	for (int k = 0; k < count; ++k) {
+		Boundary* boundary = getWaterBoundary(x[k], y[k]);
+
+		if (boundary != NULL) {
+			waterHeight[k] = boundary->getLocalWaterTableHeight();
+			water[k] = true;
+		} else if (useGlobalWaterTable != 0) {
+			waterHeight[k] = globalWaterTableHeight;
+			water[k] = true;
+		} else {
+			waterHeight[k] = 0;
+			water[k] = false;
+		}
+
+		wet += water[k];
+	}
+
+	return wet;
+}
+
+Layer* ProceduralTerrainAppearance::getLayerRecursive(float x, float y, Layer* rootParent, const uint32* containingLayers) {
 	Layer* returnLayer = NULL;
 
+	if (!TerrainLayerIndex::contains(containingLayers, rootParent))
+		return NULL;
+
 	Vector<Boundary*>* boundaries = rootParent->getBoundaries();
 
 	for (int i = 0; i < boundaries->size(); ++i) {
@@ -147,7 +389,7 @@ Layer* ProceduralTerrainAppearance::getLayerRecursive(float x, float y, Layer* r
 	for (int i = 0; i < children->size(); ++i) {
 		Layer* layer = children->get(i);
 
-		returnLayer = getLayerRecursive(x, y, layer);
+		returnLayer = getLayerRecursive(x, y, layer, containingLayers);
 
 		if (returnLayer != NULL)
 			return returnLayer;
@@ -163,13 +405,15 @@ Layer* ProceduralTerrainAppearance::getLayer(float x, float y) {
 
 	Vector<Layer*>* layers = layersGroup->getLayers();
 
+	const uint32* containingLayers = layerIndex->getContainingLayers(x, y);
+
 	for (int i = 0; i < layers->size(); ++i) {
 		Layer* layer = layers->get(i);
 
 		if (!layer->isEnabled())
 			continue;
 
-		returnLayer = getLayerRecursive(x, y, layer);
+		returnLayer = getLayerRecursive(x, y, layer, containingLayers);
 
 		if (returnLayer != NULL)
 			return returnLayer;
@@ -179,91 +423,147 @@ Layer* ProceduralTerrainAppearance::getLayer(float x, float y) {
 	return returnLayer;
 }
 
-float ProceduralTerrainAppearance::calculateFeathering(float value, int featheringType) {
-	/* 1: x^2
-	 * 2: sqrt(x)
-	 * 3: x^2 * (3 - 2x)
-	 */
+Vector<TerrainChunk*>* ProceduralTerrainAppearance::generateTerrainChunks(float minX, float minY, float size, float distanceBetweenHeights, int oneChunkNumRows, int oneChunkNumColumns, float chunkSize) {
+	Vector<TerrainChunk*>* chunks = new Vector<TerrainChunk*>();
 
+	int numRows = size / chunkSize;
+	int numColumns = numRows;
 
-	float result = value;
+	float originX = minX;
+	float originY = minY;
 
-	switch (featheringType) {
-	case 1:
-		result = result * result;
-		break;
-	case 2:
-		result = sqrt(result);
-		break;
-	case 3:
-		result = result * result * (3 - 2 * result);
-		break;
-	case 0:
-		//result = result;
-		break;
-	default:
-		result = 0;
-		break;
+	// chunks are created up front so the result keeps its row by row order
+	for (int row = 0; row < numRows; ++row) {
+		float currentY = originY + (chunkSize * row);
+
+		for (int col = 0; col < numColumns; ++col) {
+			float currentX = originX + ( chunkSize * col );
+
+			chunks->add(new TerrainChunk(currentX, currentY, oneChunkNumRows, oneChunkNumColumns, chunkPool));
+		}
 	}
 
-	return result;
+	TerrainChunkTask task(this, chunks, distanceBetweenHeights);
+
+	TerrainWorkerPool pool(generationThreads);
+	pool.execute(&task, chunks->size());
+
+	return chunks;
 }
 
-Vector<TerrainChunk*>* ProceduralTerrainAppearance::generateTerrainChunks(float minX, float minY, float size, float distanceBetweenHeights, int oneChunkNumRows, int oneChunkNumColumns, float chunkSize) {
-	Vector<TerrainChunk*>* chunks = new Vector<TerrainChunk*>();
+int ProceduralTerrainAppearance::regenerateTerrainChunks(Vector<TerrainChunk*>* chunks, float distanceBetweenHeights, const TerrainRegion& region) {
+	Vector<TerrainChunk*> touched;
 
-	//for (float y = minY; y < maxY; 
+	for (int i = 0; i < chunks->size(); ++i) {
+		TerrainChunk* chunk = chunks->get(i);
 
-	LayersGroup* layersGroup = terrainGenerator->getLayersGroup();
+		// rows run along x, see generateTerrainChunk
+		float minX = chunk->getOriginX();
+		float minY = chunk->getOriginY();
+		float maxX = minX + (chunk->getNumRows() - 1) * distanceBetweenHeights;
+		float maxY = minY + (chunk->getNumColumns() - 1) * distanceBetweenHeights;
 
-	Vector<Layer*>* layers = layersGroup->getLayers();
+		// the slopes of the edge samples come from heights outside the chunk
+		float border = slopeFilters ? slopeSpacing : 0;
 
-	int numRows = size / chunkSize;
-	int numColumns = numRows;
+		if (!region.intersects(minX - border, minY - border, maxX + border, maxY + border))
+			continue;
 
-	float originX = minX;
-	float originY = minY;
+		chunk->reset(minX, minY);
 
-	for (int row = 0; row < numRows; ++row) {
-        float currentY = originY + (chunkSize * row);
-
-		for (int col = 0; col < numColumns; ++col) {
-            float currentX = originX + ( chunkSize * col );
-
-			TerrainChunk* chunk = new TerrainChunk(currentX, currentY, oneChunkNumRows, oneChunkNumColumns);
-
-			for (int i = 0; i < oneChunkNumRows; ++i) {
-				for (int j = 0; j < oneChunkNumColumns; ++j) {
-					float workX = currentX + (i * distanceBetweenHeights);
-					float workY = currentY + (j * distanceBetweenHeights);
-
-					float affectorTransform = 1.0;
+		touched.add(chunk);
+	}
 
-					float transformValue = 0;
-					float fullTraverse = 0;
-
-					for (int l = 0; l < layers->size(); ++l) {
-						Layer* layer = layers->get(l);
-	
-						if (layer->isEnabled()) {
-							transformValue = processTerrain(layer, workX, workY, fullTraverse, affectorTransform, AffectorProceduralRule::ALL, chunk, i, j);
+	TerrainChunkTask task(this, &touched, distanceBetweenHeights);
 
-							float inChunkHeight = chunk->getHeight(i, j);
+	TerrainWorkerPool pool(generationThreads);
+	pool.execute(&task, touched.size());
 
-							if (fullTraverse != inChunkHeight) {
-								transformValue--;
-							}
-						}
+	return touched.size();
+}
 
-					}
-				}
-			}
-
-			chunks->add(chunk);
-		}
+TerrainRegion ProceduralTerrainAppearance::getFootprint(Layer* layer) {
+	TerrainRegion region;
+
+	float minX, minY, maxX, maxY;
+
+	if (TerrainLayerIndex::getAffectedArea(layer, minX, minY, maxX, maxY))
+		region.add(minX, minY, maxX, maxY);
+	else
+		region.addEverywhere();
+
+	return region;
+}
+
+TerrainRegion ProceduralTerrainAppearance::getReach(const TerrainRegion& region) {
+	if (!slopeFilters || region.isEmpty() || region.isEverywhere())
+		return region;
+
+	TerrainRegion reach;
+	reach.add(region.getMinX() - slopeSpacing, region.getMinY() - slopeSpacing, region.getMaxX() + slopeSpacing, region.getMaxY() + slopeSpacing);
+
+	return reach;
+}
+
+void ProceduralTerrainAppearance::updateLayers(const TerrainRegion& region) {
+	layerIndex->build(terrainGenerator->getLayersGroup(), size);
+	waterIndex->build(&waterBoundaries, size);
+
+	slopeFilters = hasSlopeFilters(terrainGenerator->getLayersGroup()->getLayers());
+
+	if (compiledLayers)
+		compileLayers();
+
+	if (heightCache != NULL)
+		heightCache->invalidate(getReach(region));
+
+	if (profiler != NULL)
+		enableProfiler();
+}
+
+void ProceduralTerrainAppearance::generateTerrainChunk(TerrainChunk* chunk, float distanceBetweenHeights) {
+	float currentX = chunk->getOriginX();
+	float currentY = chunk->getOriginY();
+
+	float* normalData = NULL;
+
+	if (slopeFilters) {
+		int count = chunk->getNumRows() * chunk->getNumColumns();
+
+		// the same points the layers get below, so the chunk sees the slopes the point queries see
+		float* x = new float[count];
+		float* y = new float[count];
+
+		for (int i = 0; i < chunk->getNumRows(); ++i) {
+			for (int j = 0; j < chunk->getNumColumns(); ++j) {
+				x[i * chunk->getNumColumns() + j] = currentX + (i * distanceBetweenHeights);
+				y[i * chunk->getNumColumns() + j] = currentY + (j * distanceBetweenHeights);
+			}
+		}
+
+		normalData = new float[count];
+		getSlopeNormals(x, y, count, normalData);
+
+		delete [] x;
+		delete [] y;
+
+		chunk->setNormalData(normalData);
 	}
 
-	return chunks;
+	for (int i = 0; i < chunk->getNumRows(); ++i) {
+		for (int j = 0; j < chunk->getNumColumns(); ++j) {
+			float workX = currentX + (i * distanceBetweenHeights);
+			float workY = currentY + (j * distanceBetweenHeights);
+
+			float fullTraverse = 0;
+
+			processLayers(workX, workY, fullTraverse, AffectorProceduralRule::ALL, chunk, i, j);
+		}
+	}
+
+	chunk->setNormalData(NULL);
+
+	delete [] normalData;
 }
 
 float ProceduralTerrainAppearance::processBoundaries(Vector<Boundary*>* boundaries, float x, float y) {
@@ -279,7 +579,16 @@ float ProceduralTerrainAppearance::processBoundaries(Vector<Boundary*>* boundari
 		} else
 			hasBoundaries = true;
 
-		float result = boundary->process(x, y);
+		float result;
+
+		if (profiler != NULL) {
+			uint64 start = Time::currentNanoTime();
+
+			result = boundary->process(x, y);
+
+			profiler->record(boundary, start, result == 0);
+		} else
+			result = boundary->process(x, y);
 
 		int featheringType = boundary->getFeatheringType();
 
@@ -309,6 +618,8 @@ float ProceduralTerrainAppearance::processFilters(Vector<FilterProceduralRule*>*
 		/*if (!(filter->getFilterType() & affectorType))
 			continue;*/
 
+		uint64 start = profiler != NULL ? Time::currentNanoTime() : 0;
+
 		float result = filter->process(x, y, transformValue, baseValue, terrainGenerator, chunk, row, column);
 
 		int featheringType = filter->getFeatheringType();
@@ -318,6 +629,9 @@ float ProceduralTerrainAppearance::processFilters(Vector<FilterProceduralRule*>*
 		if (transformValue > result)
 			transformValue = result;
 
+		if (profiler != NULL)
+			profiler->record(filter, start, transformValue == 0);
+
 		if (transformValue == 0)
 			break;
 	}
@@ -325,11 +639,13 @@ float ProceduralTerrainAppearance::processFilters(Vector<FilterProceduralRule*>*
 	return transformValue;
 }
 
-float ProceduralTerrainAppearance::processTerrain(Layer* layer, float x, float y, float& baseValue, float affectorTransformValue, int affectorType, TerrainChunk* chunk, int row, int column) {
+float ProceduralTerrainAppearance::processTerrain(Layer* layer, float x, float y, float& baseValue, float affectorTransformValue, int affectorType, TerrainChunk* chunk, int row, int column, const uint32* affectingLayers) {
 	Vector<Boundary*>* boundaries = layer->getBoundaries();
 	Vector<AffectorProceduralRule*>* affectors = layer->getAffectors();
 	Vector<FilterProceduralRule*>* filters = layer->getFilters();
 
+	uint64 start = profiler != NULL ? Time::currentNanoTime() : 0;
+
 	float transformValue = processBoundaries(boundaries, x, y);
 
 	if (layer->invertBoundaries())
@@ -345,7 +661,16 @@ float ProceduralTerrainAppearance::processTerrain(Layer* layer, float x, float y
 			for (int i = 0; i < affectors->size(); ++i) {
 				AffectorProceduralRule* affector = affectors->get(i);
 
-				if (affector->isEnabled() && (affector->getAffectorType() & affectorType))
+				if (!affector->isEnabled() || !(affector->getAffectorType() & affectorType))
+					continue;
+
+				if (profiler != NULL) {
+					uint64 affectorStart = Time::currentNanoTime();
+
+					affector->process(x, y, transformValue * affectorTransformValue, baseValue, terrainGenerator, chunk, row, column);
+
+					profiler->record(affector, affectorStart, false);
+				} else
 					affector->process(x, y, transformValue * affectorTransformValue, baseValue, terrainGenerator, chunk, row, column);
 			}
 
@@ -355,8 +680,8 @@ float ProceduralTerrainAppearance::processTerrain(Layer* layer, float x, float y
 			for (int i = 0; i < children->size(); ++i) {
 				Layer* layer = children->get(i);
 
-				if (layer->isEnabled()) {
-					processTerrain(layer, x, y, baseValue, affectorTransformValue * transformValue, affectorType, chunk, row, column);
+				if (layer->isEnabled() && TerrainLayerIndex::contains(affectingLayers, layer)) {
+					processTerrain(layer, x, y, baseValue, affectorTransformValue * transformValue, affectorType, chunk, row, column, affectingLayers);
 				}
 			}
 
@@ -364,91 +689,714 @@ float ProceduralTerrainAppearance::processTerrain(Layer* layer, float x, float y
 
 	}
 
+	if (profiler != NULL)
+		profiler->record(layer, start, transformValue == 0);
+
 	return transformValue;
 }
 
-int ProceduralTerrainAppearance::getEnvironmentID(float x, float y) {
-	LayersGroup* layersGroup = terrainGenerator->getLayersGroup();
+void ProceduralTerrainAppearance::processLayers(float x, float y, float& baseValue, int affectorType, TerrainChunk* chunk, int row, int column) {
+	const uint32* affectingLayers = layerIndex->getAffectingLayers(x, y);
 
-	Vector<Layer*>* layers = layersGroup->getLayers();
+	if (programs.size() != 0 && profiler == NULL) {
+		// chunk filters read the base value back from the chunk, those need every layer
+		TerrainProgram* program = programs.get(programs.size() - 1);
 
-	float affectorTransform = 1.0;
+		for (int i = 0; i < programs.size() - 1 && chunk == NULL; ++i) {
+			if (programs.get(i)->getAffectorType() == affectorType)
+				program = programs.get(i);
+		}
 
-	float transformValue = 0;
-	float fullTraverse = 0;
+		program->execute(x, y, baseValue, affectorType, terrainGenerator, chunk, row, column, affectingLayers);
+		return;
+	}
+
+	Vector<Layer*>* layers = terrainGenerator->getLayersGroup()->getLayers();
 
 	for (int i = 0; i < layers->size(); ++i) {
 		Layer* layer = layers->get(i);
 
-		if (layer->isEnabled())
-			transformValue = processTerrain(layer, x, y, fullTraverse, affectorTransform, AffectorProceduralRule::ENVIRONMENT, NULL, 0, 0);
+		if (layer->isEnabled() && TerrainLayerIndex::contains(affectingLayers, layer))
+			processTerrain(layer, x, y, baseValue, 1.0, affectorType, chunk, row, column, affectingLayers);
 	}
+}
 
-	//info("full traverse height ... is " + String::valueOf(fullTraverse) + " in mili:" + String::valueOf(start.miliDifference()), true);
+// affector types feeding each TerrainSample channel
+static const int channelAffectorTypes[TerrainSample::CHANNELS] = {
+		AffectorProceduralRule::HEIGHTTYPE,
+		AffectorProceduralRule::ENVIRONMENT,
+		AffectorProceduralRule::SHADER,
+		AffectorProceduralRule::COLOR,
+		AffectorProceduralRule::FLORA
+};
 
-	return fullTraverse;
-}
+void ProceduralTerrainAppearance::processChannels(Layer* layer, float x, float y, float* values, const float* affectorTransformValues, int channels, TerrainChunk* colors, int row, int column, const uint32* affectingLayers) {
+	uint64 start = profiler != NULL ? Time::currentNanoTime() : 0;
 
-ShaderFamily* ProceduralTerrainAppearance::getShaderFamily(int shaderFamilyId) {
-	ShadersGroup* group = terrainGenerator->getShadersGroup();
+	float transformValue = processBoundaries(layer->getBoundaries(), x, y);
+
+	if (layer->invertBoundaries())
+		transformValue = 1.0 - transformValue;
+
+	if (transformValue == 0) {
+		if (profiler != NULL)
+			profiler->record(layer, start, true);
 
-	Vector<ShaderFamily*>* data = group->getShaderFamilies();
+		return;
+	}
+
+	Vector<FilterProceduralRule*>* filters = layer->getFilters();
+
+	// each query hands the filters its own base value, only filters ignoring it can be shared
+	bool sharedFilters = true;
 
-	//String fileName
+	for (int i = 0; i < filters->size() && sharedFilters; ++i) {
+		FilterProceduralRule* filter = filters->get(i);
+
+		if (filter->isEnabled() && filter->usesBaseValue())
+			sharedFilters = false;
+	}
 
-	for (int i = 0; i < data->size(); ++i) {
-		ShaderFamily* fam = data->get(i);
+	float transformValues[TerrainSample::CHANNELS];
+	float sharedTransformValue = 0;
+	bool filtered = false;
+	int live = 0;
 
-		if (fam->getID() == shaderFamilyId) {
-			return fam;
+	for (int channel = 0; channel < TerrainSample::CHANNELS; ++channel) {
+		if (!(channels & (1 << channel)))
+			continue;
+
+		float value = sharedTransformValue;
+
+		if (!sharedFilters || !filtered) {
+			value = transformValue;
+
+			processFilters(filters, x, y, value, values[channel], NULL, 0, 0);
+
+			if (layer->invertFilters())
+				value = 1.0 - value;
+
+			sharedTransformValue = value;
+			filtered = true;
 		}
+
+		transformValues[channel] = value;
+
+		if (value != 0)
+			live |= 1 << channel;
 	}
 
-	return NULL;
+	if (live == 0) {
+		if (profiler != NULL)
+			profiler->record(layer, start, true);
+
+		return;
+	}
+
+	Vector<AffectorProceduralRule*>* affectors = layer->getAffectors();
+
+	for (int i = 0; i < affectors->size(); ++i) {
+		AffectorProceduralRule* affector = affectors->get(i);
+
+		if (!affector->isEnabled())
+			continue;
+
+		int affectorType = affector->getAffectorType();
+
+		for (int channel = 0; channel < TerrainSample::CHANNELS; ++channel) {
+			if (!(live & (1 << channel)) || !(affectorType & channelAffectorTypes[channel]))
+				continue;
+
+			float value = transformValues[channel] * affectorTransformValues[channel];
+
+			uint64 affectorStart = profiler != NULL ? Time::currentNanoTime() : 0;
+
+			// the float base value can't hold a whole color, only the chunk gets it
+			// exactly. Color affectors index the chunk (j, i), hence column, row
+			if (channel == TerrainSample::COLOR)
+				affector->process(x, y, value, values[channel], terrainGenerator, colors, column, row);
+			else
+				affector->process(x, y, value, values[channel], terrainGenerator, NULL, 0, 0);
+
+			if (profiler != NULL)
+				profiler->record(affector, affectorStart, false);
+		}
+	}
+
+	float childTransformValues[TerrainSample::CHANNELS];
+
+	for (int channel = 0; channel < TerrainSample::CHANNELS; ++channel) {
+		if (live & (1 << channel))
+			childTransformValues[channel] = affectorTransformValues[channel] * transformValues[channel];
+	}
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i) {
+		Layer* child = children->get(i);
+
+		if (child->isEnabled() && TerrainLayerIndex::contains(affectingLayers, child))
+			processChannels(child, x, y, values, childTransformValues, live, colors, row, column, affectingLayers);
+	}
+
+	if (profiler != NULL)
+		profiler->record(layer, start, false);
 }
 
-ShaderFamily* ProceduralTerrainAppearance::getShaderFamily(float x, float y) {
-	LayersGroup* layersGroup = terrainGenerator->getLayersGroup();
+void ProceduralTerrainAppearance::processChannels(float x, float y, TerrainSample& sample, TerrainChunk* colors, int row, int column) {
+	const uint32* affectingLayers = layerIndex->getAffectingLayers(x, y);
 
-	Vector<Layer*>* layers = layersGroup->getLayers();
+	float values[TerrainSample::CHANNELS];
+	float affectorTransformValues[TerrainSample::CHANNELS];
 
-	float affectorTransform = 1.0;
+	for (int channel = 0; channel < TerrainSample::CHANNELS; ++channel) {
+		values[channel] = 0;
+		affectorTransformValues[channel] = 1.0;
+	}
 
-	float transformValue = 0;
-	float fullTraverse = 0;
+	Vector<Layer*>* layers = terrainGenerator->getLayersGroup()->getLayers();
 
 	for (int i = 0; i < layers->size(); ++i) {
 		Layer* layer = layers->get(i);
 
-		if (layer->isEnabled())
-			transformValue = processTerrain(layer, x, y, fullTraverse, affectorTransform, AffectorProceduralRule::SHADER, NULL, 0, 0);
+		if (layer->isEnabled() && TerrainLayerIndex::contains(affectingLayers, layer))
+			processChannels(layer, x, y, values, affectorTransformValues, (1 << TerrainSample::CHANNELS) - 1, colors, row, column, affectingLayers);
 	}
 
+	sample.height = values[TerrainSample::HEIGHT];
+	sample.environmentId = (int) values[TerrainSample::ENVIRONMENT];
+	sample.shaderFamilyId = (int) values[TerrainSample::SHADER];
+	sample.color = colors->getColor(row, column);
+	sample.floraFamilyId = (int) values[TerrainSample::FLORA];
+}
+
+void ProceduralTerrainAppearance::getSample(float x, float y, TerrainSample& sample) {
+	TerrainChunk colors(x, y, 1, 1);
+
+	processChannels(x, y, sample, &colors, 0, 0);
+}
+
+void ProceduralTerrainAppearance::sampleTerrain(float originX, float originY, float spacing, int rows, int columns, TerrainSample* out) {
+	TerrainChunk colors(originX, originY, rows, columns);
+
+	for (int row = 0; row < rows; ++row) {
+		for (int column = 0; column < columns; ++column)
+			processChannels(originX + column * spacing, originY + row * spacing, out[row * columns + column], &colors, row, column);
+	}
+}
+
+void ProceduralTerrainAppearance::processLayer(Layer* layer, float x, float y, float& baseValue, int affectorType) {
+	const uint32* affectingLayers = layerIndex->getAffectingLayers(x, y);
+
+	if (layer->isEnabled() && TerrainLayerIndex::contains(affectingLayers, layer))
+		processTerrain(layer, x, y, baseValue, 1.0, affectorType, NULL, 0, 0, affectingLayers);
+}
+
+int ProceduralTerrainAppearance::getEnvironmentID(float x, float y) {
+	float fullTraverse = 0;
+
+	processLayers(x, y, fullTraverse, AffectorProceduralRule::ENVIRONMENT, NULL, 0, 0);
+
 	//info("full traverse height ... is " + String::valueOf(fullTraverse) + " in mili:" + String::valueOf(start.miliDifference()), true);
 
-	return getShaderFamily((int)fullTraverse);
+	return fullTraverse;
 }
 
-float ProceduralTerrainAppearance::getHeight(float x, float y) {
-	LayersGroup* layersGroup = terrainGenerator->getLayersGroup();
+int ProceduralTerrainAppearance::getFloraFamilyID(float x, float y) {
+	float fullTraverse = 0;
 
-	Vector<Layer*>* layers = layersGroup->getLayers();
+	processLayers(x, y, fullTraverse, AffectorProceduralRule::FLORA, NULL, 0, 0);
 
-	float affectorTransform = 1.0;
+	return fullTraverse;
+}
+
+/**
+ * Seed of one flora tile, mixed so neighbouring tiles draw unrelated values.
+ * trn::ptat::Random wants it positive.
+ */
+static int getFloraTileSeed(uint32 seed, int column, int row) {
+	uint32 hash = seed ^ ((uint32) column * 0x9E3779B1u) ^ ((uint32) row * 0x85EBCA77u);
+
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6Bu;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35u;
+	hash ^= hash >> 16;
+
+	hash &= 0x7FFFFFFF;
+
+	return hash != 0 ? hash : 1;
+}
+
+bool ProceduralTerrainAppearance::getCollidableFlora(int column, int row, TerrainFloraPlacement& placement) {
+	float tileSize = floraCollidableTileSize;
+
+	if (!(tileSize > 0))
+		return false;
+
+	trn::ptat::Random random;
+	random.setSeed(getFloraTileSeed((uint32) (int) floraCollidableSeed, column, row));
+
+	// always the same draws in the same order, whatever the tile ends up holding
+	float offsetX = random.next() / 2147483648.0;
+	float offsetY = random.next() / 2147483648.0;
+	float chance = random.next() / 2147483648.0;
+	float pick = random.next() / 2147483648.0;
+
+	float border = floraCollidableTileBorder;
+
+	if (!(border > 0))
+		border = 0;
+	else if (border > tileSize * 0.5f)
+		border = tileSize * 0.5f;
+
+	float x = column * tileSize + border + offsetX * (tileSize - 2 * border);
+	float y = row * tileSize + border + offsetY * (tileSize - 2 * border);
+
+	int familyId = getFloraFamilyID(x, y);
+
+	if (familyId == 0)
+		return false;
+
+	FloraFamily* family = terrainGenerator->getFloraGroup()->getFloraFamily(familyId);
+
+	if (family == NULL || chance >= family->getWeight())
+		return false;
+
+	float waterHeight;
+
+	if (getWater(x, y, waterHeight) != family->isAquaticFamily())
+		return false;
+
+	// FloraData::var1 weighs the children, all alike when none has a weight
+	Vector<FloraData*>* children = family->getFloraData();
+
+	if (children->size() == 0)
+		return false;
+
+	float totalWeight = 0;
+
+	for (int i = 0; i < children->size(); ++i) {
+		float weight = children->get(i)->var1;
+
+		if (weight > 0)
+			totalWeight += weight;
+	}
+
+	int childIndex = children->size() - 1;
+
+	if (totalWeight > 0) {
+		float target = pick * totalWeight;
+
+		for (int i = 0; i < children->size(); ++i) {
+			float weight = children->get(i)->var1;
+
+			if (weight > 0 && (target -= weight) < 0) {
+				childIndex = i;
+				break;
+			}
+		}
+	} else {
+		int index = (int) (pick * children->size());
+
+		if (index < childIndex)
+			childIndex = index;
+	}
+
+	placement.x = x;
+	placement.y = y;
+	placement.height = getHeight(x, y);
+	placement.familyId = familyId;
+	placement.childIndex = childIndex;
+
+	return true;
+}
+
+TerrainFloraIndex* ProceduralTerrainAppearance::generateCollidableFlora(float minX, float minY, float maxX, float maxY) {
+	float tileSize = floraCollidableTileSize;
+
+	if (!(tileSize > 0) || !(minX <= maxX && minY <= maxY))
+		return new TerrainFloraIndex(tileSize > 0 ? tileSize : 1, 0, 0, 0, 0);
+
+	int firstColumn = (int) floor(minX / tileSize);
+	int firstRow = (int) floor(minY / tileSize);
+
+	int columns = (int) floor(maxX / tileSize) - firstColumn + 1;
+	int rows = (int) floor(maxY / tileSize) - firstRow + 1;
+
+	TerrainFloraIndex* index = new TerrainFloraIndex(tileSize, firstColumn, firstRow, columns, rows);
+
+	TerrainFloraPlacement* placements = new TerrainFloraPlacement[columns * rows];
+	bool* planted = new bool[columns * rows];
+
+	TerrainFloraTask task(this, firstColumn, firstRow, columns, placements, planted);
+
+	TerrainWorkerPool pool(generationThreads);
+	pool.execute(&task, rows);
+
+	index->build(placements, planted);
+
+	delete [] placements;
+	delete [] planted;
+
+	return index;
+}
+
+ShaderFamily* ProceduralTerrainAppearance::getShaderFamily(int shaderFamilyId) {
+	return terrainGenerator->getShadersGroup()->getShaderFamily(shaderFamilyId);
+}
+
+ShaderFamily* ProceduralTerrainAppearance::getShaderFamily(float x, float y) {
+	float fullTraverse = 0;
+
+	processLayers(x, y, fullTraverse, AffectorProceduralRule::SHADER, NULL, 0, 0);
+
+	//info("full traverse height ... is " + String::valueOf(fullTraverse) + " in mili:" + String::valueOf(start.miliDifference()), true);
+
+	return getShaderFamily((int)fullTraverse);
+}
+
+float ProceduralTerrainAppearance::getHeight(float x, float y) {
+	if (heightCache != NULL)
+		return heightCache->getHeight(x, y);
 
-	float transformValue = 0;
 	float fullTraverse = 0;
 
 	//Time start;
 
+	processLayers(x, y, fullTraverse, AffectorProceduralRule::HEIGHTTYPE, NULL, 0, 0);
+
+	//info("full traverse height ... is " + String::valueOf(fullTraverse) + " in mili:" + String::valueOf(start.miliDifference()), true);
+
+	return fullTraverse;
+}
+
+void ProceduralTerrainAppearance::sampleHeights(float originX, float originY, float spacing, int rows, int columns, float* out) {
+	if (profiler != NULL) {
+		for (int row = 0; row < rows; ++row) {
+			for (int column = 0; column < columns; ++column) {
+				float height = 0;
+
+				processLayers(originX + column * spacing, originY + row * spacing, height, AffectorProceduralRule::HEIGHTTYPE, NULL, 0, 0);
+
+				out[row * columns + column] = height;
+			}
+		}
+
+		return;
+	}
+
+	TerrainGrid grid;
+	TerrainGridLevel* samples = grid.getLevel(0);
+
+	int total = rows * columns;
+
+	for (int start = 0; start < total; start += grid.getCapacity()) {
+		int count = total - start;
+
+		if (count > grid.getCapacity())
+			count = grid.getCapacity();
+
+		for (int k = 0; k < count; ++k) {
+			int row = (start + k) / columns;
+			int column = (start + k) % columns;
+
+			samples->x[k] = originX + column * spacing;
+			samples->y[k] = originY + row * spacing;
+			samples->baseValue[k] = 0;
+			samples->affectorTransformValue[k] = 1.0;
+		}
+
+		samples->size = count;
+
+		// rows of the block span the whole width unless it holds a single row
+		int firstRow = start / columns;
+		int lastRow = (start + count - 1) / columns;
+		int firstColumn = firstRow == lastRow ? start % columns : 0;
+		int lastColumn = firstRow == lastRow ? (start + count - 1) % columns : columns - 1;
+
+		float x0 = originX + firstColumn * spacing, x1 = originX + lastColumn * spacing;
+		float y0 = originY + firstRow * spacing, y1 = originY + lastRow * spacing;
+
+		processHeightsGrid(&grid, x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1, x0 < x1 ? x1 : x0, y0 < y1 ? y1 : y0);
+
+		memcpy(out + start, samples->baseValue, count * sizeof(float));
+	}
+}
+
+void ProceduralTerrainAppearance::sampleHeights(const float* x, const float* y, int count, float* out) {
+	// the heights of a slope are part of its filter's time, not counted again
+	if (profiler != NULL && !isSamplingSlopes()) {
+		for (int k = 0; k < count; ++k) {
+			float height = 0;
+
+			processLayers(x[k], y[k], height, AffectorProceduralRule::HEIGHTTYPE, NULL, 0, 0);
+
+			out[k] = height;
+		}
+
+		return;
+	}
+
+	TerrainGrid grid;
+	TerrainGridLevel* samples = grid.getLevel(0);
+
+	for (int start = 0; start < count; start += grid.getCapacity()) {
+		int blockCount = count - start;
+
+		if (blockCount > grid.getCapacity())
+			blockCount = grid.getCapacity();
+
+		float minX = x[start], minY = y[start];
+		float maxX = minX, maxY = minY;
+
+		for (int k = 0; k < blockCount; ++k) {
+			float sampleX = x[start + k], sampleY = y[start + k];
+
+			samples->x[k] = sampleX;
+			samples->y[k] = sampleY;
+			samples->baseValue[k] = 0;
+			samples->affectorTransformValue[k] = 1.0;
+
+			if (sampleX < minX)
+				minX = sampleX;
+			else if (sampleX > maxX)
+				maxX = sampleX;
+
+			if (sampleY < minY)
+				minY = sampleY;
+			else if (sampleY > maxY)
+				maxY = sampleY;
+		}
+
+		samples->size = blockCount;
+
+		processHeightsGrid(&grid, minX, minY, maxX, maxY);
+
+		memcpy(out + start, samples->baseValue, blockCount * sizeof(float));
+	}
+}
+
+void ProceduralTerrainAppearance::processHeightsGrid(TerrainGrid* grid, float minX, float minY, float maxX, float maxY) {
+	Vector<Layer*>* layers = terrainGenerator->getLayersGroup()->getLayers();
+
+	uint32* affectingLayers = grid->getAffectingLayersBuffer(layerIndex->getWords());
+
+	if (!layerIndex->getAffectingLayers(minX, minY, maxX, maxY, affectingLayers))
+		affectingLayers = NULL;
+
 	for (int i = 0; i < layers->size(); ++i) {
 		Layer* layer = layers->get(i);
 
-		if (layer->isEnabled())
-			transformValue = processTerrain(layer, x, y, fullTraverse, affectorTransform, AffectorProceduralRule::HEIGHTTYPE, NULL, 0, 0);
+		if (layer->isEnabled() && TerrainLayerIndex::contains(affectingLayers, layer))
+			processTerrainGrid(layer, grid, 0, AffectorProceduralRule::HEIGHTTYPE, affectingLayers);
 	}
+}
 
-	//info("full traverse height ... is " + String::valueOf(fullTraverse) + " in mili:" + String::valueOf(start.miliDifference()), true);
+void ProceduralTerrainAppearance::getSlopeNormals(const float* x, const float* y, int count, float* normalZ) {
+	float* neighbourX = new float[4 * count];
+	float* neighbourY = new float[4 * count];
 
-	return fullTraverse;
+	for (int k = 0; k < count; ++k) {
+		float* pointX = neighbourX + 4 * k;
+		float* pointY = neighbourY + 4 * k;
+
+		pointX[0] = x[k] - slopeSpacing;
+		pointX[1] = x[k] + slopeSpacing;
+		pointX[2] = pointX[3] = x[k];
+
+		pointY[0] = pointY[1] = y[k];
+		pointY[2] = y[k] - slopeSpacing;
+		pointY[3] = y[k] + slopeSpacing;
+	}
+
+	float* heights = new float[4 * count];
+
+	// slope filters asking while these run get nothing instead of asking again
+	ProceduralTerrainAppearance* sampling = slopeSampling.get();
+	slopeSampling.set(this);
+
+	sampleHeights(neighbourX, neighbourY, 4 * count, heights);
+
+	slopeSampling.set(sampling);
+
+	TerrainNormals::computePoints(heights, count, slopeSpacing, normalZ);
+
+	delete [] neighbourX;
+	delete [] neighbourY;
+	delete [] heights;
+}
+
+void ProceduralTerrainAppearance::sampleNormals(float originX, float originY, float spacing, int rows, int columns, float* normalX, float* normalY, float* normalZ) {
+	float* heights = new float[(rows + 2) * (columns + 2)];
+
+	sampleHeights(originX - spacing, originY - spacing, spacing, rows + 2, columns + 2, heights);
+
+	TerrainNormals::compute(heights, rows, columns, spacing, normalX, normalY, normalZ);
+
+	delete [] heights;
+}
+
+int ProceduralTerrainAppearance::sampleWalkable(float originX, float originY, float spacing, int rows, int columns, float maxSlope, bool* walkable) {
+	float* normalZ = new float[rows * columns];
+
+	sampleNormals(originX, originY, spacing, rows, columns, NULL, NULL, normalZ);
+
+	int count = TerrainNormals::getWalkable(normalZ, rows * columns, maxSlope, walkable);
+
+	delete [] normalZ;
+
+	return count;
+}
+
+void ProceduralTerrainAppearance::processBoundariesGrid(Vector<Boundary*>* boundaries, TerrainGrid* grid, int depth) {
+	TerrainGridLevel* parent = grid->getLevel(depth);
+	TerrainGridLevel* level = grid->getLevel(depth + 1);
+
+	int count = parent->size;
+	float* transformValue = level->transformValue;
+
+	for (int k = 0; k < count; ++k)
+		transformValue[k] = 0;
+
+	bool hasBoundaries = false;
+
+	for (int i = 0; i < boundaries->size(); ++i) {
+		Boundary* boundary = boundaries->get(i);
+
+		if (!boundary->isEnabled())
+			continue;
+		else
+			hasBoundaries = true;
+
+		boundary->processSamples(parent->x, parent->y, count, level->result);
+
+		int featheringType = boundary->getFeatheringType();
+
+		for (int k = 0; k < count; ++k) {
+			if (transformValue[k] >= 1)
+				continue;
+
+			float result = calculateFeathering(level->result[k], featheringType);
+
+			if (result > transformValue[k])
+				transformValue[k] = result;
+		}
+	}
+
+	if (!hasBoundaries) {
+		for (int k = 0; k < count; ++k)
+			transformValue[k] = 1.0;
+	}
+}
+
+void ProceduralTerrainAppearance::processFiltersGrid(Vector<FilterProceduralRule*>* filters, TerrainGrid* grid, int depth) {
+	TerrainGridLevel* level = grid->getLevel(depth + 1);
+
+	int count = level->size;
+	float* transformValue = level->transformValue;
+
+	for (int i = 0; i < filters->size(); ++i) {
+		FilterProceduralRule* filter = filters->get(i);
+
+		if (!filter->isEnabled())
+			continue;
+
+		filter->processSamples(level->x, level->y, transformValue, level->baseValue, count, terrainGenerator, level->result);
+
+		int featheringType = filter->getFeatheringType();
+
+		for (int k = 0; k < count; ++k) {
+			if (transformValue[k] == 0)
+				continue;
+
+			float result = calculateFeathering(level->result[k], featheringType);
+
+			if (transformValue[k] > result)
+				transformValue[k] = result;
+		}
+	}
+}
+
+void ProceduralTerrainAppearance::processTerrainGrid(Layer* layer, TerrainGrid* grid, int depth, int affectorType, const uint32* affectingLayers) {
+	TerrainGridLevel* parent = grid->getLevel(depth);
+	TerrainGridLevel* level = grid->getLevel(depth + 1);
+
+	Vector<AffectorProceduralRule*>* affectors = layer->getAffectors();
+
+	processBoundariesGrid(layer->getBoundaries(), grid, depth);
+
+	float* transformValue = level->transformValue;
+
+	if (layer->invertBoundaries()) {
+		for (int k = 0; k < parent->size; ++k)
+			transformValue[k] = 1.0 - transformValue[k];
+	}
+
+	// keep only the samples inside the boundaries, compacting in place
+	int count = 0;
+
+	for (int k = 0; k < parent->size; ++k) {
+		if (transformValue[k] == 0)
+			continue;
+
+		level->parentIndex[count] = k;
+		level->x[count] = parent->x[k];
+		level->y[count] = parent->y[k];
+		level->baseValue[count] = parent->baseValue[k];
+		transformValue[count] = transformValue[k];
+		++count;
+	}
+
+	level->size = count;
+
+	if (count == 0)
+		return;
+
+	processFiltersGrid(layer->getFilters(), grid, depth);
+
+	if (layer->invertFilters()) {
+		for (int k = 0; k < count; ++k)
+			transformValue[k] = 1.0 - transformValue[k];
+	}
+
+	// samples the filters rejected keep the base value they came with
+	int accepted = 0;
+
+	for (int k = 0; k < count; ++k) {
+		if (transformValue[k] == 0)
+			continue;
+
+		level->parentIndex[accepted] = level->parentIndex[k];
+		level->x[accepted] = level->x[k];
+		level->y[accepted] = level->y[k];
+		level->baseValue[accepted] = level->baseValue[k];
+		transformValue[accepted] = transformValue[k];
+		level->affectorTransformValue[accepted] = transformValue[k] * parent->affectorTransformValue[level->parentIndex[k]];
+		++accepted;
+	}
+
+	level->size = count = accepted;
+
+	if (count == 0)
+		return;
+
+	for (int i = 0; i < affectors->size(); ++i) {
+		AffectorProceduralRule* affector = affectors->get(i);
+
+		if (affector->isEnabled() && (affector->getAffectorType() & affectorType))
+			affector->processSamples(level->x, level->y, level->affectorTransformValue, level->baseValue, count, terrainGenerator);
+	}
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i) {
+		Layer* child = children->get(i);
+
+		if (child->isEnabled() && TerrainLayerIndex::contains(affectingLayers, child))
+			processTerrainGrid(child, grid, depth + 1, affectorType, affectingLayers);
+	}
+
+	for (int k = 0; k < count; ++k)
+		parent->baseValue[level->parentIndex[k]] = level->baseValue[k];
 }
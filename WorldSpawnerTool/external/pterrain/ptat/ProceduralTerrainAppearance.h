@@ -9,6 +9,7 @@
 #define PROCEDURALTERRAINAPPEARANCE_H_
 
 #include "TemplateVariable.h"
+#include "TerrainRegion.h"
 
 class TerrainGenerator;
 class Boundary;
@@ -18,6 +19,16 @@ class Boundary;
 class ShaderFamily;
 class Layer;
 class TerrainChunk;
+class TerrainGrid;
+class TerrainLayerIndex;
+class TerrainWaterIndex;
+class TerrainProgram;
+class TerrainSample;
+class TerrainHeightCache;
+class TerrainChunkPool;
+class TerrainProfiler;
+class TerrainFloraIndex;
+class TerrainFloraPlacement;
 class FilterProceduralRule;
 
 class ProceduralTerrainAppearance : public TemplateVariable<'PTAT'>, public Logger {
@@ -25,8 +36,15 @@ class ProceduralTerrainAppearance : public TemplateVariable<'PTAT'>, public Logg
 
 	Vector<Boundary*> waterBoundaries;
 
+	// where the water boundaries are, built by load(). Emptied when one is
+	// inserted afterwards, getWater then checks them all
+	TerrainWaterIndex* waterIndex;
+
 	TerrainMaps* terrainMaps;
 
+	// which layers can matter where, rebuilt by load()
+	TerrainLayerIndex* layerIndex;
+
 	//float defaultHeight;
 
 	String terrainFile;
@@ -65,18 +83,103 @@ class ProceduralTerrainAppearance : public TemplateVariable<'PTAT'>, public Logg
 	float radialFarTileBorder;
 	float radialFarSeed;
 
+	int generationThreads;
+
+	// flattened layers, empty unless setCompiledLayers(true). One program per
+	// query type, the last one is compiled for AffectorProceduralRule::ALL
+	Vector<TerrainProgram*> programs;
+	bool compiledLayers;
+
+	// answers getHeight when set, emptied by load()
+	TerrainHeightCache* heightCache;
+
+	// blocks of deleted chunks, reused by generateTerrainChunks
+	TerrainChunkPool* chunkPool;
+
+	// per rule counters while profiling, made again by load()
+	TerrainProfiler* profiler;
+
+	// whether an enabled layer has an enabled FilterSlope, chunks then get
+	// their normals before the layers run
+	bool slopeFilters;
+
+	// distance to the heights slopes are measured from, one terrain tile
+	float slopeSpacing;
+
+	// set on the threads measuring slopes, see getSlopeNormals
+	ThreadLocal<ProceduralTerrainAppearance*> slopeSampling;
+
 protected:
-	float calculateFeathering(float value, int featheringType);
-	float processTerrain(Layer* layer, float x, float y, float& baseValue, float affectorTransformValue, int affectorType, TerrainChunk* chunk, int row, int column);
-	Layer* getLayerRecursive(float x, float y, Layer* rootParent);
+	float processTerrain(Layer* layer, float x, float y, float& baseValue, float affectorTransformValue, int affectorType, TerrainChunk* chunk, int row, int column, const uint32* affectingLayers = NULL);
+	Layer* getLayerRecursive(float x, float y, Layer* rootParent, const uint32* containingLayers = NULL);
 	Layer* getLayer(float x, float y);
 
+	/**
+	 * First water boundary containing the point, NULL for none.
+	 */
+	Boundary* getWaterBoundary(float x, float y);
+
+	/**
+	 * Runs every enabled layer for one sample, through the compiled program when there is one.
+	 */
+	void processLayers(float x, float y, float& baseValue, int affectorType, TerrainChunk* chunk, int row, int column);
+
+	void compileLayers();
+	void releasePrograms();
+
+	static bool hasSlopeFilters(Vector<Layer*>* layers);
+
 	float processBoundaries(Vector<Boundary*>* boundaries, float x, float y);
 	float processFilters(Vector<FilterProceduralRule*>* filters, float x, float y, float& transformValue, float& baseValue, TerrainChunk* chunk, int row, int column);
 
+	/**
+	 * processTerrain for every channel of a TerrainSample at once. Boundaries are shared,
+	 * filters that look at the base value run once per live channel.
+	 */
+	void processChannels(Layer* layer, float x, float y, float* values, const float* affectorTransformValues, int channels, TerrainChunk* colors, int row, int column, const uint32* affectingLayers);
+	void processChannels(float x, float y, TerrainSample& sample, TerrainChunk* colors, int row, int column);
+
+	void processTerrainGrid(Layer* layer, TerrainGrid* grid, int depth, int affectorType, const uint32* affectingLayers);
+
+	/**
+	 * Heights of the samples filled in the first level of grid, all inside minX..maxX, minY..maxY.
+	 */
+	void processHeightsGrid(TerrainGrid* grid, float minX, float minY, float maxX, float maxY);
+	void processBoundariesGrid(Vector<Boundary*>* boundaries, TerrainGrid* grid, int depth);
+	void processFiltersGrid(Vector<FilterProceduralRule*>* filters, TerrainGrid* grid, int depth);
+
 
 public:
 	ProceduralTerrainAppearance(TerrainGenerator* terrainGenerator);
+
+	static inline float calculateFeathering(float value, int featheringType) {
+		/* 1: x^2
+		 * 2: sqrt(x)
+		 * 3: x^2 * (3 - 2x)
+		 */
+
+		float result = value;
+
+		switch (featheringType) {
+		case 1:
+			result = result * result;
+			break;
+		case 2:
+			result = sqrt(result);
+			break;
+		case 3:
+			result = result * result * (3 - 2 * result);
+			break;
+		case 0:
+			//result = result;
+			break;
+		default:
+			result = 0;
+			break;
+		}
+
+		return result;
+	}
 	~ProceduralTerrainAppearance();
 
 	bool load(engine::util::IffStream* iffStream);
@@ -84,9 +187,7 @@ public:
 	void parseFromIffStream(engine::util::IffStream* iffStream);
 	void parseFromIffStream(engine::util::IffStream* iffStream, Version<'0014'>);
 
-	void insertWaterBoundary(Boundary* boundary) {
-		waterBoundaries.add(boundary);
-	}
+	void insertWaterBoundary(Boundary* boundary);
 
 	bool hasGlobalWaterTableOption() {
 		return useGlobalWaterTable;
@@ -108,8 +209,106 @@ public:
 		return &waterBoundaries;
 	}
 
+	/**
+	 * The chunks take their memory from the chunk pool and give it back when
+	 * deleted, so they must be deleted before this terrain.
+	 */
 	Vector<TerrainChunk*>* generateTerrainChunks(float minX, float minY, float size, float distanceBetweenHeights, int oneChunkNumRows, int oneChunkNumColumns, float chunkSize);
 
+	/**
+	 * Fills the height, shader and color planes of one chunk. Safe to call for
+	 * different chunks from several threads at once.
+	 */
+	void generateTerrainChunk(TerrainChunk* chunk, float distanceBetweenHeights);
+
+	/**
+	 * Generates again, in parallel, the chunks with samples inside region and
+	 * leaves the others alone. Returns how many were generated.
+	 */
+	int regenerateTerrainChunks(Vector<TerrainChunk*>* chunks, float distanceBetweenHeights, const TerrainRegion& region);
+
+	/**
+	 * Where the rules of layer can change the terrain. Editing a rule changes
+	 * the footprint before the edit plus the one after it.
+	 */
+	TerrainRegion getFootprint(Layer* layer);
+
+	/**
+	 * Where heights changing inside region can change the terrain: region
+	 * itself, grown by the slope spacing when slope filters are loaded.
+	 */
+	TerrainRegion getReach(const TerrainRegion& region);
+
+	/**
+	 * Call after editing the loaded layers, with the footprints of the edits.
+	 * Rebuilds the layer and water indices and the compiled layers, and drops
+	 * the cached heights inside region. Edited rules that look things up in
+	 * executeRule need it called again. Not while queries are running.
+	 */
+	void updateLayers(const TerrainRegion& region);
+
+	/**
+	 * Number of threads generateTerrainChunks and generateCollidableFlora use, 0 (the default) for one per processor.
+	 */
+	inline void setGenerationThreads(int threads) {
+		generationThreads = threads;
+	}
+
+	inline int getGenerationThreads() {
+		return generationThreads;
+	}
+
+	inline TerrainChunkPool* getChunkPool() {
+		return chunkPool;
+	}
+
+	/**
+	 * Starts counting calls, early outs and time of every layer and rule. Queries
+	 * walk the layer tree while profiling, compiled layers and the grid paths are
+	 * bypassed so every rule is seen.
+	 */
+	void enableProfiler();
+	void disableProfiler();
+
+	inline TerrainProfiler* getProfiler() {
+		return profiler;
+	}
+
+	inline TerrainGenerator* getTerrainGenerator() {
+		return terrainGenerator;
+	}
+
+	/**
+	 * Walks a single top level layer for one sample, the part of a query it
+	 * accounts for. Lets tools tell the expensive layers apart.
+	 */
+	void processLayer(Layer* layer, float x, float y, float& baseValue, int affectorType);
+
+	/**
+	 * Evaluates samples with a flat instruction program compiled from the layer tree instead
+	 * of walking the layers recursively. Compiled now and again on every load().
+	 */
+	void setCompiledLayers(bool enabled);
+
+	inline bool hasCompiledLayers() {
+		return programs.size() != 0;
+	}
+
+	/**
+	 * Puts a TerrainHeightCache of the given tile size (meters), resolution (cells per
+	 * tile side) and memory cap (bytes) in front of getHeight. Cached heights are
+	 * interpolated between samples tileSize / resolution apart.
+	 */
+	void enableHeightCache(float tileSize = 64, int resolution = 32, uint64 memoryCap = 16 * 1024 * 1024);
+	void disableHeightCache();
+
+	/**
+	 * The cache in use for its hit counters, NULL when disabled.
+	 */
+	inline TerrainHeightCache* getHeightCache() {
+		return heightCache;
+	}
+
 	/**
 	 * Returns the size of the terrain.
 	 * @return float The size of the terrain.
@@ -119,9 +318,95 @@ public:
 	}
 
 	bool getWater(float x, float y, float& waterHeight);
+
+	/**
+	 * getWater for count points: water[k] tells whether there is water at
+	 * (x[k], y[k]) and waterHeight[k] its height, 0 where there is none.
+	 * Returns how many points have water.
+	 */
+	int getWater(const float* x, const float* y, int count, float* waterHeight, bool* water);
+
 	float getHeight(float x, float y);
+
+	/**
+	 * Fills out[row * columns + column] with getHeight(originX + column * spacing, originY + row * spacing).
+	 * Each layer is evaluated for a whole block of samples at a time, which is much faster than
+	 * calling getHeight for every point.
+	 */
+	void sampleHeights(float originX, float originY, float spacing, int rows, int columns, float* out);
+
+	/**
+	 * getHeight for count points, out[k] for (x[k], y[k]), evaluated like sampleHeights.
+	 */
+	void sampleHeights(const float* x, const float* y, int count, float* out);
+
+	/**
+	 * Cosine of the slope angle at count points, what FilterSlope compares
+	 * against whichever query runs it. Measured from the heights one slope
+	 * spacing to either side of the point, which are evaluated with every
+	 * slope filter passing nothing.
+	 */
+	void getSlopeNormals(const float* x, const float* y, int count, float* normalZ);
+
+	/**
+	 * Whether the calling thread is evaluating the heights of getSlopeNormals.
+	 */
+	inline bool isSamplingSlopes() {
+		return slopeSampling.get() == this;
+	}
+
+	inline float getSlopeSpacing() {
+		return slopeSpacing;
+	}
+
+	/**
+	 * Terrain normals over a grid laid out like sampleHeights, from the heights
+	 * one spacing around every point. normalX and normalY may be NULL, normalZ
+	 * is the cosine of the slope angle.
+	 */
+	void sampleNormals(float originX, float originY, float spacing, int rows, int columns, float* normalX, float* normalY, float* normalZ);
+
+	/**
+	 * walkable[row * columns + column] tells whether the slope there is at most
+	 * maxSlope radians, see sampleNormals. Returns how many points are walkable.
+	 */
+	int sampleWalkable(float originX, float originY, float spacing, int rows, int columns, float maxSlope, bool* walkable);
+
 	int getEnvironmentID(float x, float y);
+
+	/**
+	 * Collidable flora family the layers put at the point, 0 for none.
+	 */
+	int getFloraFamilyID(float x, float y);
+
+	/**
+	 * The plant of collidable flora tile (column, row), tiles of
+	 * floraCollidableTileSize counted from the terrain origin. Each tile
+	 * draws from its own trn::ptat::Random seeded by the PTAT collidable
+	 * flora seed and its position, so a tile always gets the same plant
+	 * whatever else was asked for. False when the tile holds none.
+	 */
+	bool getCollidableFlora(int column, int row, TerrainFloraPlacement& placement);
+
+	/**
+	 * getCollidableFlora for every tile touching minX..maxX, minY..maxY,
+	 * tile rows spread over the generation threads. The caller owns the
+	 * index, which is the same for any number of threads.
+	 */
+	TerrainFloraIndex* generateCollidableFlora(float minX, float minY, float maxX, float maxY);
 	ShaderFamily* getShaderFamily(float x, float y);
+
+	/**
+	 * Height, environment, shader, color and flora at one point from a single
+	 * walk of the layers, the same values the separate queries give.
+	 */
+	void getSample(float x, float y, TerrainSample& sample);
+
+	/**
+	 * getSample for every point of a grid, laid out like sampleHeights.
+	 */
+	void sampleTerrain(float originX, float originY, float spacing, int rows, int columns, TerrainSample* out);
+
 	ShaderFamily* getShaderFamily(int shaderFamilyId);
 
 
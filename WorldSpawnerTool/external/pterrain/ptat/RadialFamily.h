@@ -74,6 +74,14 @@ public:
 
 		iffStream->closeChunk('RFAM');
 	}
+
+	inline int getID() {
+		return familyId;
+	}
+
+	String getFamilyName() {
+		return familyName;
+	}
 };
 
 
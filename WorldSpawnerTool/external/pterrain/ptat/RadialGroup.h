@@ -14,7 +14,14 @@
 
 class RadialGroup : public TemplateVariable<'RGRP'> {
 	Vector<RadialFamily*> data;
+
+	// radial families by id
+	HashTable<int, RadialFamily*> families;
+
 public:
+	RadialGroup() {
+		families.setNullValue(NULL);
+	}
 
 	~RadialGroup() {
 		while (data.size() > 0)
@@ -46,9 +53,20 @@ public:
 			ffam->readObject(iffStream);
 
 			data.add(ffam);
+
+			if (!families.containsKey(ffam->getID()))
+				families.put(ffam->getID(), ffam);
 		}
 	}
 
+	Vector<RadialFamily*>* getRadialFamilies() {
+		return &data;
+	}
+
+	inline RadialFamily* getRadialFamily(int familyId) {
+		return families.get(familyId);
+	}
+
 };
 
 
@@ -14,10 +14,14 @@
 class ShadersGroup : public TemplateVariable<'SGRP'> {
 	Vector<ShaderFamily*> data;
 
+	// families by id, a repeated id keeps the first family read which is what
+	// getShaderFamily returned when it scanned data
+	HashTable<int, ShaderFamily*> families;
+
 public:
 
 	ShadersGroup() {
-
+		families.setNullValue(NULL);
 	}
 
 	~ShadersGroup() {
@@ -49,6 +53,9 @@ public:
 			ShaderFamily* sfam = new ShaderFamily();
 			sfam->readObject(iffStream);
 			data.add(sfam);
+
+			if (!families.containsKey(sfam->getID()))
+				families.put(sfam->getID(), sfam);
 		}
 
 	}
@@ -57,6 +64,10 @@ public:
 		return &data;
 	}
 
+	inline ShaderFamily* getShaderFamily(int familyId) {
+		return families.get(familyId);
+	}
+
 };
 
 #endif /* SURFACEGROUP_H_ */
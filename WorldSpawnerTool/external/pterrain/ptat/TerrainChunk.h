@@ -48,12 +48,26 @@ which carries forward this exception.
 #ifndef TERRAINCHUNK_H_
 #define TERRAINCHUNK_H_
 
+#include "TerrainChunkPool.h"
+
 class TerrainChunk {
 protected:
 	int* shaderData;
 	int* colorData;
 	float* heightData;
 
+	// one block holding the height and shader planes in that order. The
+	// color plane is malloc'd on its own so takeColorData can hand it over
+	void* block;
+	int blockSize;
+
+	// where the block came from and goes back to, NULL for malloc
+	TerrainChunkPool* pool;
+
+	// normalZ of every sample while the chunk is generated, not owned. NULL
+	// when no filter needs it
+	float* normalData;
+
 	float originX;
 	float originY;
 
@@ -61,37 +75,58 @@ protected:
 	int numColumns;
 
 public:
-	TerrainChunk(float originX, float originY, int numRows, int numColumns) {
+	/**
+	 * A chunk taking its block from pool must be deleted before the pool.
+	 */
+	TerrainChunk(float originX, float originY, int numRows, int numColumns, TerrainChunkPool* pool = NULL) {
 		this->numRows = numRows;
 		this->numColumns = numColumns;
+		this->pool = pool;
 
-		int intSize = sizeof(int) * numRows * sizeof(int) * numColumns;
-		int floatSize = sizeof(float) * numRows * sizeof(float) * numColumns;
+		normalData = NULL;
 
-		shaderData = (int*) malloc(intSize);
-		memset(shaderData, 0, (intSize));
+		int planeSize = numRows * numColumns;
 
-		colorData = (int*) malloc(intSize);
+		blockSize = planeSize * (sizeof(float) + sizeof(int));
 
-		for (int i = 0; i < numRows ; i++) {
-			for (int j = 0; j < numColumns; ++j) {
-				setColor(i, j, 0xFFFFFFFF);
-			}
-			
-		}
-		//memset(colorData, 0, (intSize));
+		if (pool != NULL)
+			block = pool->allocateBlock(blockSize);
+		else
+			block = malloc(blockSize);
 
-		heightData = (float*) malloc((floatSize));
-		memset(heightData, 0, (floatSize));
+		heightData = (float*) block;
+		shaderData = (int*) (heightData + planeSize);
+		colorData = NULL;
 
-		this->originX = originX;
-		this->originY = originY;
+		reset(originX, originY);
 	}
 
 	~TerrainChunk() {
-		free(shaderData);
+		if (pool != NULL)
+			pool->releaseBlock(block, blockSize);
+		else
+			free(block);
+
 		free(colorData);
-		free(heightData);
+	}
+
+	/**
+	 * Moves the chunk and clears its planes, as if it had just been created.
+	 */
+	void reset(float originX, float originY) {
+		int planeSize = numRows * numColumns;
+
+		memset(heightData, 0, planeSize * sizeof(float));
+		memset(shaderData, 0, planeSize * sizeof(int));
+
+		if (colorData == NULL)
+			colorData = (int*) malloc(planeSize * sizeof(int));
+
+		for (int i = 0; i < planeSize; ++i)
+			colorData[i] = 0xFFFFFFFF;
+
+		this->originX = originX;
+		this->originY = originY;
 	}
 
 	void setHeight(int i, int j, float val) {
@@ -108,6 +143,25 @@ public:
 		return heightData[i * numColumns + j];
 	}
 
+	/**
+	 * Plane laid out like the height plane, the caller keeps it alive until
+	 * it sets NULL again.
+	 */
+	void setNormalData(float* normalData) {
+		this->normalData = normalData;
+	}
+
+	bool hasNormals() {
+		return normalData != NULL;
+	}
+
+	float getNormalZ(int i, int j) {
+		if (i >= numRows || j >= numColumns || i < 0 || j < 0)
+			return -1;
+
+		return normalData[i * numColumns + j];
+	}
+
 	int getShader(int i, int j) {
 		if (i >= numRows || j >= numColumns || i < 0 || j < 0)
 			return -1;
@@ -136,9 +190,14 @@ public:
 		colorData[i * numColumns + j] = color;
 	}
 
+	/**
+	 * Hands the color plane to the caller, who releases it with free(). The
+	 * chunk has none until reset() gives it a new one.
+	 */
 	int* takeColorData() {
 		int* temp = colorData;
 		colorData = NULL;
+
 		return temp;
 	}
 
@@ -150,6 +209,14 @@ public:
 		return originX;
 	}
 
+	int getNumRows() {
+		return numRows;
+	}
+
+	int getNumColumns() {
+		return numColumns;
+	}
+
 	int* getShaderData() {
 		return shaderData;
 	}
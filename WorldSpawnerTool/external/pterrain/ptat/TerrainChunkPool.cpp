@@ -0,0 +1,73 @@
+/*
+ * TerrainChunkPool.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainChunkPool.h"
+
+TerrainChunkPool::TerrainChunkPool(uint64 memoryCap) {
+	blockSize = 0;
+
+	this->memoryCap = memoryCap;
+
+	allocations = 0;
+	reuses = 0;
+}
+
+TerrainChunkPool::~TerrainChunkPool() {
+	clear();
+}
+
+void TerrainChunkPool::clear() {
+	Locker locker(&mutex);
+
+	for (int i = 0; i < blocks.size(); ++i)
+		free(blocks.get(i));
+
+	blocks.removeAll();
+}
+
+void* TerrainChunkPool::allocateBlock(int size) {
+	mutex.lock();
+
+	if (size == blockSize && blocks.size() != 0) {
+		void* block = blocks.remove(blocks.size() - 1);
+
+		++reuses;
+
+		mutex.unlock();
+
+		return block;
+	}
+
+	++allocations;
+
+	mutex.unlock();
+
+	return malloc(size);
+}
+
+void TerrainChunkPool::releaseBlock(void* block, int size) {
+	mutex.lock();
+
+	// chunks changed size, the old blocks won't be asked for again
+	if (size != blockSize) {
+		for (int i = 0; i < blocks.size(); ++i)
+			free(blocks.get(i));
+
+		blocks.removeAll();
+
+		blockSize = size;
+	}
+
+	if ((uint64) (blocks.size() + 1) * size <= memoryCap) {
+		blocks.add(block);
+
+		block = NULL;
+	}
+
+	mutex.unlock();
+
+	free(block);
+}
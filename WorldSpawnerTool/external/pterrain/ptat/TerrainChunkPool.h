@@ -0,0 +1,58 @@
+/*
+ * TerrainChunkPool.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINCHUNKPOOL_H_
+#define TERRAINCHUNKPOOL_H_
+
+#include "engine/engine.h"
+
+/**
+ * Keeps the blocks of deleted TerrainChunks for the next ones, so generating
+ * a planet chunk after chunk reuses the same memory instead of going back to
+ * the allocator. Only blocks of one size are kept, the size of the last
+ * block released; chunks of other sizes still work, they just aren't reused.
+ * Safe to use from several threads.
+ */
+class TerrainChunkPool {
+	Mutex mutex;
+
+	Vector<void*> blocks;
+	int blockSize;
+
+	uint64 memoryCap;
+
+	uint64 allocations;
+	uint64 reuses;
+
+public:
+	/**
+	 * @param memoryCap bytes of unused blocks to keep at most
+	 */
+	TerrainChunkPool(uint64 memoryCap = 64 * 1024 * 1024);
+	~TerrainChunkPool();
+
+	void* allocateBlock(int size);
+	void releaseBlock(void* block, int size);
+
+	/**
+	 * Frees every unused block.
+	 */
+	void clear();
+
+	inline uint64 getAllocations() {
+		return allocations;
+	}
+
+	inline uint64 getReuses() {
+		return reuses;
+	}
+
+	inline int getFreeBlocks() {
+		return blocks.size();
+	}
+};
+
+#endif /* TERRAINCHUNKPOOL_H_ */
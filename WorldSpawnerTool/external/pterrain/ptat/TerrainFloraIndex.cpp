@@ -0,0 +1,98 @@
+/*
+ * TerrainFloraIndex.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainFloraIndex.h"
+
+#include <math.h>
+
+TerrainFloraIndex::TerrainFloraIndex(float tileSize, int firstColumn, int firstRow, int columns, int rows) {
+	this->tileSize = tileSize;
+	this->firstColumn = firstColumn;
+	this->firstRow = firstRow;
+	this->columns = columns > 0 ? columns : 0;
+	this->rows = rows > 0 ? rows : 0;
+
+	placements = NULL;
+	count = 0;
+
+	int tiles = this->columns * this->rows;
+
+	tileStart = new int[tiles + 1];
+	memset(tileStart, 0, (tiles + 1) * sizeof(int));
+}
+
+TerrainFloraIndex::~TerrainFloraIndex() {
+	delete [] placements;
+	delete [] tileStart;
+}
+
+void TerrainFloraIndex::build(const TerrainFloraPlacement* tilePlacements, const bool* planted) {
+	int tiles = columns * rows;
+
+	count = 0;
+
+	for (int tile = 0; tile < tiles; ++tile) {
+		tileStart[tile] = count;
+		count += planted[tile];
+	}
+
+	tileStart[tiles] = count;
+
+	delete [] placements;
+	placements = new TerrainFloraPlacement[count > 0 ? count : 1];
+
+	for (int tile = 0; tile < tiles; ++tile) {
+		if (planted[tile])
+			placements[tileStart[tile]] = tilePlacements[tile];
+	}
+}
+
+int TerrainFloraIndex::getPlacements(float x, float y, float radius, Vector<TerrainFloraPlacement*>& found) {
+	if (!(radius >= 0) || columns == 0 || rows == 0)
+		return 0;
+
+	// plants stay inside their tile, so the tiles under the query box hold
+	// them all. One more on every side for those rounded onto a tile edge
+	int minColumn = (int) floor((x - radius) / tileSize) - firstColumn - 1;
+	int maxColumn = (int) floor((x + radius) / tileSize) - firstColumn + 1;
+	int minRow = (int) floor((y - radius) / tileSize) - firstRow - 1;
+	int maxRow = (int) floor((y + radius) / tileSize) - firstRow + 1;
+
+	if (minColumn < 0)
+		minColumn = 0;
+
+	if (minRow < 0)
+		minRow = 0;
+
+	if (maxColumn >= columns)
+		maxColumn = columns - 1;
+
+	if (maxRow >= rows)
+		maxRow = rows - 1;
+
+	float radiusSquared = radius * radius;
+	int added = 0;
+
+	for (int row = minRow; row <= maxRow; ++row) {
+		for (int column = minColumn; column <= maxColumn; ++column) {
+			int tile = row * columns + column;
+
+			for (int i = tileStart[tile]; i < tileStart[tile + 1]; ++i) {
+				TerrainFloraPlacement* placement = &placements[i];
+
+				float deltaX = placement->x - x;
+				float deltaY = placement->y - y;
+
+				if (deltaX * deltaX + deltaY * deltaY <= radiusSquared) {
+					found.add(placement);
+					++added;
+				}
+			}
+		}
+	}
+
+	return added;
+}
@@ -0,0 +1,88 @@
+/*
+ * TerrainFloraIndex.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINFLORAINDEX_H_
+#define TERRAINFLORAINDEX_H_
+
+#include "engine/engine.h"
+
+/**
+ * One collidable plant, see ProceduralTerrainAppearance::getCollidableFlora.
+ */
+class TerrainFloraPlacement {
+public:
+	float x, y;
+	float height;
+
+	int familyId;
+
+	// which of the family's FloraData
+	int childIndex;
+};
+
+/**
+ * Collidable flora of a block of flora tiles, kept in tile order with the
+ * start of every tile's plants, so the plants near a point are found by
+ * looking at the tiles around it.
+ */
+class TerrainFloraIndex {
+	float tileSize;
+
+	// the first tile, in tiles from the terrain origin
+	int firstColumn, firstRow;
+	int columns, rows;
+
+	TerrainFloraPlacement* placements;
+	int count;
+
+	// the plants of tile t are placements[tileStart[t]] up to placements[tileStart[t + 1]]
+	int* tileStart;
+
+public:
+	TerrainFloraIndex(float tileSize, int firstColumn, int firstRow, int columns, int rows);
+	~TerrainFloraIndex();
+
+	/**
+	 * Takes the plant of every tile that has one, tiles in row by row order.
+	 */
+	void build(const TerrainFloraPlacement* tilePlacements, const bool* planted);
+
+	inline int size() {
+		return count;
+	}
+
+	inline TerrainFloraPlacement* get(int index) {
+		return &placements[index];
+	}
+
+	/**
+	 * Adds the plants at most radius away from the point to found, returns
+	 * how many were added.
+	 */
+	int getPlacements(float x, float y, float radius, Vector<TerrainFloraPlacement*>& found);
+
+	inline float getTileSize() {
+		return tileSize;
+	}
+
+	inline int getFirstColumn() {
+		return firstColumn;
+	}
+
+	inline int getFirstRow() {
+		return firstRow;
+	}
+
+	inline int getColumns() {
+		return columns;
+	}
+
+	inline int getRows() {
+		return rows;
+	}
+};
+
+#endif /* TERRAINFLORAINDEX_H_ */
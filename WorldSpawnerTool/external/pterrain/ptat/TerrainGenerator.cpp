@@ -24,6 +24,18 @@ void TerrainGenerator::processLayer(Layer* layer) {
 		terrainRules->get(i)->executeRule(terrain);
 	}
 
+	Vector<AffectorProceduralRule*>* affectors = layer->getAffectors();
+
+	for (int i = 0; i < affectors->size(); ++i) {
+		affectors->get(i)->executeRule(this);
+	}
+
+	Vector<FilterProceduralRule*>* filters = layer->getFilters();
+
+	for (int i = 0; i < filters->size(); ++i) {
+		filters->get(i)->executeRule(this);
+	}
+
 	Vector<Layer*>* childrenLayers = layer->getChildren();
 
 	for (int i = 0; i < childrenLayers->size(); ++i)
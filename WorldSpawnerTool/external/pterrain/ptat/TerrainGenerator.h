@@ -37,6 +37,10 @@ public:
 		terrain = ptat;
 	}
 
+	inline ProceduralTerrainAppearance* getTerrain() {
+		return terrain;
+	}
+
 	void processLayers();
 	void processLayer(Layer* layer);
 
@@ -59,6 +63,18 @@ public:
 		return &shaderGroup;
 	}
 
+	inline FloraGroup* getFloraGroup() {
+		return &floraGroup;
+	}
+
+	inline RadialGroup* getRadialGroup() {
+		return &radialGroup;
+	}
+
+	inline EnvironmentGroup* getEnvironmentGroup() {
+		return &environmentGroup;
+	}
+
 
 };
 
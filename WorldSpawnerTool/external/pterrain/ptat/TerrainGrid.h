@@ -0,0 +1,116 @@
+/*
+ * TerrainGrid.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINGRID_H_
+#define TERRAINGRID_H_
+
+#include "engine/engine.h"
+
+/**
+ * Samples that reached one depth of the layer tree. Arrays are
+ * contiguous so rules can run tight (or vectorized) loops over them.
+ */
+class TerrainGridLevel {
+public:
+	int size;
+	int capacity;
+
+	// index of each sample in the parent level
+	int* parentIndex;
+
+	float* x;
+	float* y;
+	float* baseValue;
+
+	// boundary/filter transform of the current layer
+	float* transformValue;
+
+	// transform including all parent layers, fed to the affectors
+	float* affectorTransformValue;
+
+	// per sample output of boundaries and filters
+	float* result;
+
+	TerrainGridLevel(int capacity) {
+		size = 0;
+		this->capacity = capacity;
+
+		parentIndex = new int[capacity];
+		x = new float[capacity];
+		y = new float[capacity];
+		baseValue = new float[capacity];
+		transformValue = new float[capacity];
+		affectorTransformValue = new float[capacity];
+		result = new float[capacity];
+	}
+
+	~TerrainGridLevel() {
+		delete [] parentIndex;
+		delete [] x;
+		delete [] y;
+		delete [] baseValue;
+		delete [] transformValue;
+		delete [] affectorTransformValue;
+		delete [] result;
+	}
+};
+
+/**
+ * Scratch space for evaluating a block of samples through the layer
+ * tree at once, one level per layer depth. Level 0 holds the block itself.
+ */
+class TerrainGrid {
+	Vector<TerrainGridLevel*> levels;
+	int capacity;
+
+	uint32* affectingLayers;
+	int affectingLayersWords;
+
+public:
+	const static int BLOCK_SIZE = 1024;
+
+	TerrainGrid(int capacity = BLOCK_SIZE) {
+		this->capacity = capacity;
+
+		affectingLayers = NULL;
+		affectingLayersWords = 0;
+	}
+
+	~TerrainGrid() {
+		for (int i = 0; i < levels.size(); ++i)
+			delete levels.get(i);
+
+		delete [] affectingLayers;
+	}
+
+	/**
+	 * Bit set of the layers that may affect the current block, see
+	 * TerrainLayerIndex. Grows to at least words entries.
+	 */
+	uint32* getAffectingLayersBuffer(int words) {
+		if (words > affectingLayersWords) {
+			delete [] affectingLayers;
+
+			affectingLayers = new uint32[words];
+			affectingLayersWords = words;
+		}
+
+		return affectingLayers;
+	}
+
+	TerrainGridLevel* getLevel(int depth) {
+		while (levels.size() <= depth)
+			levels.add(new TerrainGridLevel(capacity));
+
+		return levels.get(depth);
+	}
+
+	inline int getCapacity() {
+		return capacity;
+	}
+};
+
+#endif /* TERRAINGRID_H_ */
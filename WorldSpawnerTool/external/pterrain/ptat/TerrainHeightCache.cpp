@@ -0,0 +1,217 @@
+/*
+ * TerrainHeightCache.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainHeightCache.h"
+#include "ProceduralTerrainAppearance.h"
+
+TerrainHeightCache::TerrainHeightCache(ProceduralTerrainAppearance* terrain, float tileSize, int resolution, uint64 memoryCap) {
+	this->terrain = terrain;
+
+	if (!(tileSize > 0))
+		tileSize = 64;
+
+	if (resolution < 1)
+		resolution = 1;
+
+	this->tileSize = tileSize;
+	this->resolution = resolution;
+	this->memoryCap = memoryCap;
+
+	inverseTileSize = 1.0f / tileSize;
+	spacing = tileSize / resolution;
+
+	uint64 tileBytes = (uint64) (resolution + 1) * (resolution + 1) * sizeof(float) + sizeof(TerrainHeightTile);
+
+	maxTiles = (int) (memoryCap / tileBytes);
+
+	if (maxTiles < 1)
+		maxTiles = 1;
+
+	tiles.setNullValue(NULL);
+
+	head = NULL;
+	tail = NULL;
+	tileCount = 0;
+
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
+
+TerrainHeightCache::~TerrainHeightCache() {
+	clear();
+}
+
+void TerrainHeightCache::clear() {
+	Locker locker(&mutex);
+
+	while (head != NULL) {
+		TerrainHeightTile* tile = head;
+		head = tile->next;
+
+		delete tile;
+	}
+
+	tail = NULL;
+	tileCount = 0;
+
+	tiles.removeAll();
+}
+
+void TerrainHeightCache::invalidate(const TerrainRegion& region) {
+	if (region.isEverywhere()) {
+		clear();
+		return;
+	}
+
+	Locker locker(&mutex);
+
+	TerrainHeightTile* tile = head;
+
+	while (tile != NULL) {
+		TerrainHeightTile* next = tile->next;
+
+		float originX = (float) (int32) (tile->key >> 32) * tileSize;
+		float originY = (float) (int32) tile->key * tileSize;
+
+		if (region.intersects(originX, originY, originX + tileSize, originY + tileSize)) {
+			unlink(tile);
+			tiles.remove(tile->key);
+
+			delete tile;
+
+			--tileCount;
+		}
+
+		tile = next;
+	}
+}
+
+void TerrainHeightCache::resetCounters() {
+	Locker locker(&mutex);
+
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
+
+void TerrainHeightCache::unlink(TerrainHeightTile* tile) {
+	if (tile->previous != NULL)
+		tile->previous->next = tile->next;
+	else
+		head = tile->next;
+
+	if (tile->next != NULL)
+		tile->next->previous = tile->previous;
+	else
+		tail = tile->previous;
+
+	tile->previous = NULL;
+	tile->next = NULL;
+}
+
+void TerrainHeightCache::moveToFront(TerrainHeightTile* tile) {
+	if (tile == head)
+		return;
+
+	if (tile->previous != NULL || tile->next != NULL || tail == tile)
+		unlink(tile);
+
+	tile->next = head;
+
+	if (head != NULL)
+		head->previous = tile;
+
+	head = tile;
+
+	if (tail == NULL)
+		tail = tile;
+}
+
+float TerrainHeightCache::getHeight(float x, float y) {
+	float tileX = floor(x * inverseTileSize);
+	float tileY = floor(y * inverseTileSize);
+
+	// NaN or too far out to key, nothing worth caching
+	if (!(tileX > -2147483648.f && tileX < 2147483647.f && tileY > -2147483648.f && tileY < 2147483647.f)) {
+		float height;
+
+		terrain->sampleHeights(x, y, 0, 1, 1, &height);
+
+		return height;
+	}
+
+	float originX = tileX * tileSize;
+	float originY = tileY * tileSize;
+
+	float fx = (x - originX) / spacing;
+	float fy = (y - originY) / spacing;
+
+	// x * inverseTileSize may round across a tile edge
+	if (fx < 0)
+		fx = 0;
+
+	if (fy < 0)
+		fy = 0;
+
+	uint64 key = getKey((int) tileX, (int) tileY);
+
+	mutex.lock();
+
+	TerrainHeightTile* tile = tiles.get(key);
+
+	if (tile != NULL) {
+		++hits;
+
+		moveToFront(tile);
+
+		float height = interpolate(tile->heights, fx, fy);
+
+		mutex.unlock();
+
+		return height;
+	}
+
+	++misses;
+
+	mutex.unlock();
+
+	// sampled unlocked, another thread may fill the same tile meanwhile
+	float* heights = new float[(resolution + 1) * (resolution + 1)];
+
+	terrain->sampleHeights(originX, originY, spacing, resolution + 1, resolution + 1, heights);
+
+	float height = interpolate(heights, fx, fy);
+
+	Locker locker(&mutex);
+
+	if (tiles.get(key) != NULL) {
+		delete [] heights;
+
+		return height;
+	}
+
+	tile = new TerrainHeightTile(key, heights);
+
+	tiles.put(key, tile);
+	moveToFront(tile);
+
+	++tileCount;
+
+	while (tileCount > maxTiles) {
+		TerrainHeightTile* last = tail;
+
+		unlink(last);
+		tiles.remove(last->key);
+
+		delete last;
+
+		--tileCount;
+		++evictions;
+	}
+
+	return height;
+}
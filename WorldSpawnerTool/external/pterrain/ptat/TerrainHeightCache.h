@@ -0,0 +1,162 @@
+/*
+ * TerrainHeightCache.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINHEIGHTCACHE_H_
+#define TERRAINHEIGHTCACHE_H_
+
+#include "engine/engine.h"
+
+#include "TerrainRegion.h"
+
+class ProceduralTerrainAppearance;
+
+/**
+ * Heights of one square of terrain, (resolution + 1)^2 samples so
+ * interpolating never needs the neighbouring tile.
+ */
+class TerrainHeightTile {
+public:
+	uint64 key;
+
+	float* heights;
+
+	// least recently used order, most recent at the head
+	TerrainHeightTile* previous;
+	TerrainHeightTile* next;
+
+	TerrainHeightTile(uint64 key, float* heights) {
+		this->key = key;
+		this->heights = heights;
+
+		previous = NULL;
+		next = NULL;
+	}
+
+	~TerrainHeightTile() {
+		delete [] heights;
+	}
+};
+
+/**
+ * Answers height queries from small tiles sampled with
+ * ProceduralTerrainAppearance::sampleHeights the first time a point in
+ * them is asked for. Heights between the samples are bilinear, so the
+ * spacing (tile size / resolution) decides how close they stay to the
+ * layers. Least recently used tiles go once the memory cap is reached.
+ * Safe to use from several threads.
+ */
+class TerrainHeightCache {
+	ProceduralTerrainAppearance* terrain;
+
+	float tileSize;
+	int resolution;
+	uint64 memoryCap;
+
+	float inverseTileSize;
+	float spacing;
+	int maxTiles;
+
+	HashTable<uint64, TerrainHeightTile*> tiles;
+	TerrainHeightTile* head;
+	TerrainHeightTile* tail;
+	int tileCount;
+
+	uint64 hits;
+	uint64 misses;
+	uint64 evictions;
+
+	Mutex mutex;
+
+public:
+	/**
+	 * @param tileSize meters per tile side
+	 * @param resolution cells per tile side
+	 * @param memoryCap bytes of heights to keep at most, at least one tile is always kept
+	 */
+	TerrainHeightCache(ProceduralTerrainAppearance* terrain, float tileSize = 64, int resolution = 32, uint64 memoryCap = 16 * 1024 * 1024);
+	~TerrainHeightCache();
+
+	float getHeight(float x, float y);
+
+	/**
+	 * Drops every tile, needed whenever the layers change.
+	 */
+	void clear();
+
+	/**
+	 * Drops the tiles touching region, for edits that only change part of the terrain.
+	 */
+	void invalidate(const TerrainRegion& region);
+
+	void resetCounters();
+
+	inline uint64 getHits() {
+		return hits;
+	}
+
+	inline uint64 getMisses() {
+		return misses;
+	}
+
+	inline uint64 getEvictions() {
+		return evictions;
+	}
+
+	inline float getHitRate() {
+		uint64 total = hits + misses;
+
+		return total == 0 ? 0 : (float) hits / total;
+	}
+
+	inline int getTileCount() {
+		return tileCount;
+	}
+
+	inline float getTileSize() {
+		return tileSize;
+	}
+
+	inline int getResolution() {
+		return resolution;
+	}
+
+	inline uint64 getMemoryCap() {
+		return memoryCap;
+	}
+
+protected:
+	static inline uint64 getKey(int tileX, int tileY) {
+		return ((uint64) (uint32) tileX << 32) | (uint32) tileY;
+	}
+
+	inline float interpolate(const float* heights, float fx, float fy) {
+		int column = (int) fx;
+		int row = (int) fy;
+
+		if (column >= resolution)
+			column = resolution - 1;
+
+		if (row >= resolution)
+			row = resolution - 1;
+
+		float u = fx - column;
+		float v = fy - row;
+
+		int stride = resolution + 1;
+
+		const float* sample = heights + row * stride + column;
+
+		float top = sample[0] + (sample[1] - sample[0]) * u;
+		float bottom = sample[stride] + (sample[stride + 1] - sample[stride]) * u;
+
+		return top + (bottom - top) * v;
+	}
+
+	void moveToFront(TerrainHeightTile* tile);
+	void unlink(TerrainHeightTile* tile);
+};
+
+#endif /* TERRAINHEIGHTCACHE_H_ */
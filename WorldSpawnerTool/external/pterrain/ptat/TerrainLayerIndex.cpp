@@ -0,0 +1,329 @@
+/*
+ * TerrainLayerIndex.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainLayerIndex.h"
+#include "LayersGroup.h"
+
+// boundaries compare in float, keep a little slack around their boxes
+static const float BOUNDS_MARGIN = 1.0f;
+
+static inline float minimum(float a, float b) {
+	return a < b ? a : b;
+}
+
+static inline float maximum(float a, float b) {
+	return a > b ? a : b;
+}
+
+TerrainLayerIndex::TerrainLayerIndex() {
+	originX = 0;
+	originY = 0;
+	inverseCellSize = 0;
+	words = 0;
+
+	affecting = NULL;
+	containing = NULL;
+}
+
+TerrainLayerIndex::~TerrainLayerIndex() {
+	clear();
+}
+
+void TerrainLayerIndex::clear() {
+	delete [] affecting;
+	affecting = NULL;
+
+	delete [] containing;
+	containing = NULL;
+
+	words = 0;
+}
+
+int TerrainLayerIndex::numberLayers(Layer* layer, int index) {
+	layer->setIndex(index++);
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i)
+		index = numberLayers(children->get(i), index);
+
+	return index;
+}
+
+void TerrainLayerIndex::build(LayersGroup* layersGroup, float terrainSize) {
+	clear();
+
+	Vector<Layer*>* layers = layersGroup->getLayers();
+
+	int count = 0;
+
+	for (int i = 0; i < layers->size(); ++i)
+		count = numberLayers(layers->get(i), count);
+
+	if (count == 0 || !(terrainSize > 0))
+		return;
+
+	originX = -terrainSize / 2;
+	originY = -terrainSize / 2;
+	inverseCellSize = CELLS_PER_SIDE / terrainSize;
+
+	words = (count + 31) / 32;
+
+	int total = CELLS_PER_SIDE * CELLS_PER_SIDE * words;
+
+	affecting = new uint32[total];
+	containing = new uint32[total];
+
+	memset(affecting, 0, total * sizeof(uint32));
+	memset(containing, 0, total * sizeof(uint32));
+
+	for (int i = 0; i < layers->size(); ++i) {
+		Layer* layer = layers->get(i);
+
+		addLayer(layer, false, 0, 0, 0, 0);
+
+		bool bounded = true;
+		float minX, minY, maxX, maxY;
+
+		addContainingLayer(layer, bounded, minX, minY, maxX, maxY);
+	}
+}
+
+bool TerrainLayerIndex::getOwnBounds(Layer* layer, float& minX, float& minY, float& maxX, float& maxY) {
+	// inverted boundaries are non zero away from the boxes, and a layer
+	// without enabled boundaries covers everything its parent does
+	if (layer->invertBoundaries())
+		return false;
+
+	bool hasBoundaries = false;
+
+	Vector<Boundary*>* boundaries = layer->getBoundaries();
+
+	for (int i = 0; i < boundaries->size(); ++i) {
+		Boundary* boundary = boundaries->get(i);
+
+		if (!boundary->isEnabled())
+			continue;
+
+		float x0, y0, x1, y1;
+
+		if (!boundary->getBounds(x0, y0, x1, y1))
+			return false;
+
+		if (!hasBoundaries) {
+			minX = x0;
+			minY = y0;
+			maxX = x1;
+			maxY = y1;
+
+			hasBoundaries = true;
+		} else {
+			minX = minimum(minX, x0);
+			minY = minimum(minY, y0);
+			maxX = maximum(maxX, x1);
+			maxY = maximum(maxY, y1);
+		}
+	}
+
+	return hasBoundaries;
+}
+
+void TerrainLayerIndex::narrow(Layer* layer, bool& bounded, float& minX, float& minY, float& maxX, float& maxY) {
+	float ownMinX, ownMinY, ownMaxX, ownMaxY;
+
+	if (!getOwnBounds(layer, ownMinX, ownMinY, ownMaxX, ownMaxY))
+		return;
+
+	if (bounded) {
+		minX = maximum(minX, ownMinX);
+		minY = maximum(minY, ownMinY);
+		maxX = minimum(maxX, ownMaxX);
+		maxY = minimum(maxY, ownMaxY);
+	} else {
+		minX = ownMinX;
+		minY = ownMinY;
+		maxX = ownMaxX;
+		maxY = ownMaxY;
+
+		bounded = true;
+	}
+}
+
+bool TerrainLayerIndex::getAffectedArea(Layer* layer, float& minX, float& minY, float& maxX, float& maxY) {
+	Vector<Layer*> chain;
+
+	for (Layer* current = layer; current != NULL; current = current->getParent())
+		chain.add(current);
+
+	bool bounded = false;
+
+	for (int i = chain.size() - 1; i >= 0; --i)
+		narrow(chain.get(i), bounded, minX, minY, maxX, maxY);
+
+	if (bounded) {
+		minX -= BOUNDS_MARGIN;
+		minY -= BOUNDS_MARGIN;
+		maxX += BOUNDS_MARGIN;
+		maxY += BOUNDS_MARGIN;
+	}
+
+	return bounded;
+}
+
+void TerrainLayerIndex::addLayer(Layer* layer, bool bounded, float minX, float minY, float maxX, float maxY) {
+	narrow(layer, bounded, minX, minY, maxX, maxY);
+
+	mark(affecting, layer->getIndex(), bounded, minX, minY, maxX, maxY);
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i)
+		addLayer(children->get(i), bounded, minX, minY, maxX, maxY);
+}
+
+bool TerrainLayerIndex::addContainingLayer(Layer* layer, bool& bounded, float& minX, float& minY, float& maxX, float& maxY) {
+	// getLayerRecursive looks at every boundary, enabled or not, and then at
+	// the children whatever the boundaries said
+	bool found = false;
+	bool subtreeBounded = true;
+	float subtreeMinX = 0, subtreeMinY = 0, subtreeMaxX = 0, subtreeMaxY = 0;
+
+	Vector<Boundary*>* boundaries = layer->getBoundaries();
+
+	for (int i = 0; i < boundaries->size() && subtreeBounded; ++i) {
+		float x0, y0, x1, y1;
+
+		if (!boundaries->get(i)->getBounds(x0, y0, x1, y1)) {
+			subtreeBounded = false;
+			break;
+		}
+
+		if (!found) {
+			subtreeMinX = x0;
+			subtreeMinY = y0;
+			subtreeMaxX = x1;
+			subtreeMaxY = y1;
+
+			found = true;
+		} else {
+			subtreeMinX = minimum(subtreeMinX, x0);
+			subtreeMinY = minimum(subtreeMinY, y0);
+			subtreeMaxX = maximum(subtreeMaxX, x1);
+			subtreeMaxY = maximum(subtreeMaxY, y1);
+		}
+	}
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i) {
+		bool childBounded = true;
+		float x0, y0, x1, y1;
+
+		if (!addContainingLayer(children->get(i), childBounded, x0, y0, x1, y1))
+			continue;
+
+		if (!childBounded) {
+			subtreeBounded = false;
+		} else if (!found) {
+			subtreeMinX = x0;
+			subtreeMinY = y0;
+			subtreeMaxX = x1;
+			subtreeMaxY = y1;
+		} else {
+			subtreeMinX = minimum(subtreeMinX, x0);
+			subtreeMinY = minimum(subtreeMinY, y0);
+			subtreeMaxX = maximum(subtreeMaxX, x1);
+			subtreeMaxY = maximum(subtreeMaxY, y1);
+		}
+
+		found = true;
+	}
+
+	if (!subtreeBounded)
+		found = true;
+
+	if (found)
+		mark(containing, layer->getIndex(), subtreeBounded, subtreeMinX, subtreeMinY, subtreeMaxX, subtreeMaxY);
+
+	bounded = subtreeBounded;
+	minX = subtreeMinX;
+	minY = subtreeMinY;
+	maxX = subtreeMaxX;
+	maxY = subtreeMaxY;
+
+	return found;
+}
+
+void TerrainLayerIndex::mark(uint32* sets, int index, bool bounded, float minX, float minY, float maxX, float maxY) {
+	int firstColumn = 0, lastColumn = CELLS_PER_SIDE - 1;
+	int firstRow = 0, lastRow = CELLS_PER_SIDE - 1;
+
+	if (bounded) {
+		minX -= BOUNDS_MARGIN;
+		minY -= BOUNDS_MARGIN;
+		maxX += BOUNDS_MARGIN;
+		maxY += BOUNDS_MARGIN;
+
+		// empty, e.g. nested boxes that don't overlap
+		if (!(minX <= maxX && minY <= maxY))
+			return;
+
+		// cells are picked with the same arithmetic as the lookups so every
+		// point inside the box finds its bit set
+		float column0 = (minX - originX) * inverseCellSize;
+		float column1 = (maxX - originX) * inverseCellSize;
+		float row0 = (minY - originY) * inverseCellSize;
+		float row1 = (maxY - originY) * inverseCellSize;
+
+		if (column1 < 0 || row1 < 0 || column0 >= CELLS_PER_SIDE || row0 >= CELLS_PER_SIDE)
+			return;
+
+		if (column0 > 0)
+			firstColumn = (int) column0;
+
+		if (column1 < CELLS_PER_SIDE)
+			lastColumn = (int) column1;
+
+		if (row0 > 0)
+			firstRow = (int) row0;
+
+		if (row1 < CELLS_PER_SIDE)
+			lastRow = (int) row1;
+	}
+
+	uint32 bit = 1u << (index & 31);
+
+	for (int row = firstRow; row <= lastRow; ++row) {
+		for (int column = firstColumn; column <= lastColumn; ++column)
+			sets[(row * CELLS_PER_SIDE + column) * words + (index >> 5)] |= bit;
+	}
+}
+
+bool TerrainLayerIndex::getAffectingLayers(float minX, float minY, float maxX, float maxY, uint32* out) {
+	if (affecting == NULL)
+		return false;
+
+	int firstColumn = getColumn(minX);
+	int lastColumn = getColumn(maxX);
+	int firstRow = getRow(minY);
+	int lastRow = getRow(maxY);
+
+	if (firstColumn < 0 || lastColumn < 0 || firstRow < 0 || lastRow < 0)
+		return false;
+
+	memset(out, 0, words * sizeof(uint32));
+
+	for (int row = firstRow; row <= lastRow; ++row) {
+		for (int column = firstColumn; column <= lastColumn; ++column) {
+			const uint32* cell = affecting + (row * CELLS_PER_SIDE + column) * words;
+
+			for (int i = 0; i < words; ++i)
+				out[i] |= cell[i];
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,150 @@
+/*
+ * TerrainLayerIndex.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINLAYERINDEX_H_
+#define TERRAINLAYERINDEX_H_
+
+#include "engine/engine.h"
+
+class Layer;
+class LayersGroup;
+
+/**
+ * Static grid over the terrain, built once at load, telling for every cell
+ * which layers can possibly have an effect there. Each cell holds two bit sets
+ * indexed by Layer::getIndex():
+ *
+ * affecting: the layer's boundaries (and those of all its parents) may give a
+ * non zero transform in the cell, so processTerrain has to visit it.
+ *
+ * containing: some boundary of the layer or of one of its children may give a
+ * non zero result in the cell, so getLayerRecursive has to visit it.
+ *
+ * Points outside the terrain get NULL, which means every layer is relevant.
+ */
+class TerrainLayerIndex {
+	float originX, originY;
+	float inverseCellSize;
+
+	// uint32 words per bit set
+	int words;
+
+	uint32* affecting;
+	uint32* containing;
+
+public:
+	const static int CELLS_PER_SIDE = 64;
+
+	TerrainLayerIndex();
+	~TerrainLayerIndex();
+
+	/**
+	 * Numbers every layer of the tree and fills the cells covering
+	 * -terrainSize / 2 .. terrainSize / 2 on both axes.
+	 */
+	void build(LayersGroup* layersGroup, float terrainSize);
+
+	void clear();
+
+	inline const uint32* getAffectingLayers(float x, float y) {
+		int cell = getCell(x, y);
+
+		if (cell < 0)
+			return NULL;
+
+		return affecting + cell * words;
+	}
+
+	inline const uint32* getContainingLayers(float x, float y) {
+		int cell = getCell(x, y);
+
+		if (cell < 0)
+			return NULL;
+
+		return containing + cell * words;
+	}
+
+	/**
+	 * Union of the affecting sets of all cells touching the box, written to
+	 * out (getWords() entries). Returns false when the box leaves the grid.
+	 */
+	bool getAffectingLayers(float minX, float minY, float maxX, float maxY, uint32* out);
+
+	inline int getWords() {
+		return words;
+	}
+
+	static inline bool contains(const uint32* layers, Layer* layer);
+
+	/**
+	 * Box outside of which processTerrain never gets past the boundaries of
+	 * the layer or its parents, so its rules can't change anything there.
+	 * Returns false when there is no such box.
+	 */
+	static bool getAffectedArea(Layer* layer, float& minX, float& minY, float& maxX, float& maxY);
+
+protected:
+	/**
+	 * Box around the enabled boundaries of the layer alone, false when they
+	 * don't bound it: none enabled, one without a box, or inverted.
+	 */
+	static bool getOwnBounds(Layer* layer, float& minX, float& minY, float& maxX, float& maxY);
+
+	/**
+	 * Intersects the area of a layer's parent with the layer's own bounds.
+	 */
+	static void narrow(Layer* layer, bool& bounded, float& minX, float& minY, float& maxX, float& maxY);
+
+	inline int getColumn(float x) {
+		float column = (x - originX) * inverseCellSize;
+
+		// written so NaN fails too
+		if (!(column >= 0 && column < CELLS_PER_SIDE))
+			return -1;
+
+		return (int) column;
+	}
+
+	inline int getRow(float y) {
+		float row = (y - originY) * inverseCellSize;
+
+		if (!(row >= 0 && row < CELLS_PER_SIDE))
+			return -1;
+
+		return (int) row;
+	}
+
+	inline int getCell(float x, float y) {
+		if (affecting == NULL)
+			return -1;
+
+		int column = getColumn(x);
+		int row = getRow(y);
+
+		if (column < 0 || row < 0)
+			return -1;
+
+		return row * CELLS_PER_SIDE + column;
+	}
+
+	int numberLayers(Layer* layer, int index);
+	void addLayer(Layer* layer, bool bounded, float minX, float minY, float maxX, float maxY);
+	bool addContainingLayer(Layer* layer, bool& bounded, float& minX, float& minY, float& maxX, float& maxY);
+	void mark(uint32* sets, int index, bool bounded, float minX, float minY, float maxX, float maxY);
+};
+
+#include "layer/Layer.h"
+
+inline bool TerrainLayerIndex::contains(const uint32* layers, Layer* layer) {
+	if (layers == NULL)
+		return true;
+
+	int index = layer->getIndex();
+
+	return (layers[index >> 5] >> (index & 31)) & 1;
+}
+
+#endif /* TERRAINLAYERINDEX_H_ */
@@ -0,0 +1,103 @@
+/*
+ * TerrainNormals.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainNormals.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NORMALS_SIMD_WIDTH 4
+#else
+#define NORMALS_SIMD_WIDTH 1
+#endif
+
+#include <math.h>
+
+void TerrainNormals::compute(const float* heights, int rows, int columns, float spacing, float* normalX, float* normalY, float* normalZ) {
+	int stride = columns + 2;
+
+	// the normal of z = h(x, y) is (-dh/dx, -dh/dy, 1) normalized
+	float scale = -0.5f / spacing;
+
+	for (int row = 0; row < rows; ++row) {
+		const float* above = heights + row * stride + 1;
+		const float* center = above + stride;
+		const float* below = center + stride;
+
+		int out = row * columns;
+		int column = 0;
+
+#if NORMALS_SIMD_WIDTH == 4
+		__m128 vscale = _mm_set1_ps(scale);
+		__m128 one = _mm_set1_ps(1.0f);
+
+		for (; column + 4 <= columns; column += 4) {
+			__m128 gx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(center + column + 1), _mm_loadu_ps(center + column - 1)), vscale);
+			__m128 gy = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(below + column), _mm_loadu_ps(above + column)), vscale);
+
+			__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy)), one));
+			__m128 inverse = _mm_div_ps(one, length);
+
+			if (normalX != NULL)
+				_mm_storeu_ps(normalX + out + column, _mm_mul_ps(gx, inverse));
+
+			if (normalY != NULL)
+				_mm_storeu_ps(normalY + out + column, _mm_mul_ps(gy, inverse));
+
+			_mm_storeu_ps(normalZ + out + column, inverse);
+		}
+#endif
+
+		for (; column < columns; ++column) {
+			float gx = (center[column + 1] - center[column - 1]) * scale;
+			float gy = (below[column] - above[column]) * scale;
+
+			float inverse = 1.0f / sqrtf(gx * gx + gy * gy + 1.0f);
+
+			if (normalX != NULL)
+				normalX[out + column] = gx * inverse;
+
+			if (normalY != NULL)
+				normalY[out + column] = gy * inverse;
+
+			normalZ[out + column] = inverse;
+		}
+	}
+}
+
+void TerrainNormals::computePoints(const float* neighbours, int count, float spacing, float* normalZ) {
+	float scale = -0.5f / spacing;
+
+	for (int k = 0; k < count; ++k) {
+		const float* heights = neighbours + 4 * k;
+
+		float gx = (heights[1] - heights[0]) * scale;
+		float gy = (heights[3] - heights[2]) * scale;
+
+		normalZ[k] = 1.0f / sqrtf(gx * gx + gy * gy + 1.0f);
+	}
+}
+
+void TerrainNormals::getSlopes(const float* normalZ, int count, float* slopes) {
+	for (int k = 0; k < count; ++k) {
+		float z = normalZ[k];
+
+		slopes[k] = acosf(z < 1.0f ? z : 1.0f);
+	}
+}
+
+int TerrainNormals::getWalkable(const float* normalZ, int count, float maxSlope, bool* walkable) {
+	// slope <= maxSlope is normalZ >= cos(maxSlope) for slopes in 0..pi/2
+	float minNormalZ = cosf(maxSlope);
+
+	int walkableCount = 0;
+
+	for (int k = 0; k < count; ++k) {
+		walkable[k] = normalZ[k] >= minNormalZ;
+		walkableCount += walkable[k];
+	}
+
+	return walkableCount;
+}
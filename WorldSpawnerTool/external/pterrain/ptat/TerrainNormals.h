@@ -0,0 +1,47 @@
+/*
+ * TerrainNormals.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINNORMALS_H_
+#define TERRAINNORMALS_H_
+
+#include "engine/engine.h"
+
+/**
+ * Surface normals of a sampled height grid from central differences, four
+ * samples at a time where SSE2 is available.
+ *
+ * heights holds (rows + 2) * (columns + 2) samples, the grid plus a one
+ * sample border all around, as heights[row * (columns + 2) + column] with
+ * column running along x. The outputs hold rows * columns values without
+ * the border. Height is the z axis, so normalZ is the cosine of the slope
+ * angle: 1 on flat ground, 0 on a vertical wall.
+ */
+class TerrainNormals {
+public:
+	/**
+	 * normalX and normalY may be NULL when only normalZ is wanted.
+	 */
+	static void compute(const float* heights, int rows, int columns, float spacing, float* normalX, float* normalY, float* normalZ);
+
+	/**
+	 * normalZ for count scattered points from the heights one spacing to
+	 * either side, neighbours[4 * k] to [4 * k + 3] holding -x, +x, -y, +y.
+	 */
+	static void computePoints(const float* neighbours, int count, float spacing, float* normalZ);
+
+	/**
+	 * Slope angles in radians from the normalZ values compute() gives.
+	 */
+	static void getSlopes(const float* normalZ, int count, float* slopes);
+
+	/**
+	 * walkable[k] is whether the slope at k is at most maxSlope radians.
+	 * Returns how many samples are walkable.
+	 */
+	static int getWalkable(const float* normalZ, int count, float maxSlope, bool* walkable);
+};
+
+#endif /* TERRAINNORMALS_H_ */
@@ -0,0 +1,186 @@
+/*
+ * TerrainProfiler.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainProfiler.h"
+#include "TerrainGenerator.h"
+#include "layer/Layer.h"
+
+#include <stdio.h>
+
+const char* TerrainRuleProfile::getTypeName(int type) {
+	switch (type) {
+	case LAYER:
+		return "layer";
+	case BOUNDARY:
+		return "boundary";
+	case FILTER:
+		return "filter";
+	case AFFECTOR:
+		return "affector";
+	default:
+		return "unknown";
+	}
+}
+
+TerrainProfiler::TerrainProfiler(TerrainGenerator* terrainGenerator) {
+	indices.setNullValue(-1);
+
+	Vector<Layer*>* layers = terrainGenerator->getLayersGroup()->getLayers();
+
+	for (int i = 0; i < layers->size(); ++i)
+		addLayer(layers->get(i), NULL);
+}
+
+TerrainProfiler::~TerrainProfiler() {
+	for (int i = 0; i < allCounters.size(); ++i)
+		delete [] allCounters.get(i);
+}
+
+void TerrainProfiler::addLayer(Layer* layer, Layer* parent) {
+	addRule(layer, TerrainRuleProfile::LAYER, parent, layer->getDescription());
+
+	Vector<Boundary*>* boundaries = layer->getBoundaries();
+
+	for (int i = 0; i < boundaries->size(); ++i)
+		addRule(boundaries->get(i), TerrainRuleProfile::BOUNDARY, layer, boundaries->get(i)->getDescription());
+
+	Vector<FilterProceduralRule*>* filters = layer->getFilters();
+
+	for (int i = 0; i < filters->size(); ++i)
+		addRule(filters->get(i), TerrainRuleProfile::FILTER, layer, filters->get(i)->getDescription());
+
+	Vector<AffectorProceduralRule*>* affectors = layer->getAffectors();
+
+	for (int i = 0; i < affectors->size(); ++i)
+		addRule(affectors->get(i), TerrainRuleProfile::AFFECTOR, layer, affectors->get(i)->getDescription());
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i)
+		addLayer(children->get(i), layer);
+}
+
+void TerrainProfiler::addRule(const void* rule, int type, Layer* parent, const String& name) {
+	TerrainRuleProfile profile;
+	profile.rule = rule;
+	profile.type = type;
+	profile.parent = parent;
+	profile.name = name;
+	profile.calls = 0;
+	profile.earlyOuts = 0;
+	profile.nanos = 0;
+	profile.selfNanos = 0;
+
+	indices.put((uint64) (size_t) rule, rules.size());
+
+	rules.add(profile);
+}
+
+TerrainRuleCounters* TerrainProfiler::addThread() {
+	int size = rules.size() + 1;
+
+	TerrainRuleCounters* counters = new TerrainRuleCounters[size];
+	memset(counters, 0, size * sizeof(TerrainRuleCounters));
+
+	Locker locker(&mutex);
+
+	allCounters.add(counters);
+
+	threadCounters.set(counters);
+
+	return counters;
+}
+
+void TerrainProfiler::reset() {
+	Locker locker(&mutex);
+
+	for (int i = 0; i < allCounters.size(); ++i)
+		memset(allCounters.get(i), 0, (rules.size() + 1) * sizeof(TerrainRuleCounters));
+}
+
+void TerrainProfiler::getProfiles(Vector<TerrainRuleProfile>& profiles) {
+	Vector<TerrainRuleProfile> totals;
+
+	mutex.lock();
+
+	for (int i = 0; i < rules.size(); ++i) {
+		TerrainRuleProfile profile = rules.get(i);
+
+		for (int k = 0; k < allCounters.size(); ++k) {
+			TerrainRuleCounters* counters = &allCounters.get(k)[i];
+
+			profile.calls += counters->calls;
+			profile.earlyOuts += counters->earlyOuts;
+			profile.nanos += counters->nanos;
+		}
+
+		profile.selfNanos = profile.nanos;
+
+		totals.add(profile);
+	}
+
+	mutex.unlock();
+
+	// a layer's time holds its rules' and child layers'
+	for (int i = 0; i < totals.size(); ++i) {
+		TerrainRuleProfile& profile = totals.get(i);
+
+		if (profile.parent != NULL) {
+			TerrainRuleProfile& parent = totals.get(indices.get((uint64) (size_t) profile.parent));
+
+			parent.selfNanos = parent.selfNanos > profile.nanos ? parent.selfNanos - profile.nanos : 0;
+		}
+	}
+
+	profiles.removeAll();
+
+	for (int i = 0; i < totals.size(); ++i) {
+		TerrainRuleProfile& profile = totals.get(i);
+
+		if (profile.calls == 0)
+			continue;
+
+		int position = profiles.size();
+
+		while (position > 0 && profiles.get(position - 1).selfNanos < profile.selfNanos)
+			--position;
+
+		profiles.add(position, profile);
+	}
+}
+
+void TerrainProfiler::printReport(int lines) {
+	Vector<TerrainRuleProfile> profiles;
+	getProfiles(profiles);
+
+	// time spent in the top level layers, everything else is part of it
+	uint64 total = 0;
+
+	for (int i = 0; i < profiles.size(); ++i) {
+		TerrainRuleProfile& profile = profiles.get(i);
+
+		if (profile.type == TerrainRuleProfile::LAYER && profile.parent == NULL)
+			total += profile.nanos;
+	}
+
+	char line[256];
+
+	snprintf(line, sizeof(line), "%8s %8s %12s %11s %11s %9s  %s", "self", "type", "calls", "early outs", "self ms", "ns/call", "name");
+
+	System::out << line << endl;
+
+	for (int i = 0; i < profiles.size() && (lines <= 0 || i < lines); ++i) {
+		TerrainRuleProfile& profile = profiles.get(i);
+
+		const char* name = profile.name.isEmpty() ? "(unnamed)" : profile.name.toCharArray();
+
+		snprintf(line, sizeof(line), "%7.2f%% %8s %12llu %11llu %11.3f %9.1f  %s", total == 0 ? 0 : 100.0 * profile.selfNanos / total,
+				TerrainRuleProfile::getTypeName(profile.type), (unsigned long long) profile.calls, (unsigned long long) profile.earlyOuts,
+				profile.selfNanos / 1000000.0, (double) profile.selfNanos / profile.calls, name);
+
+		System::out << line << endl;
+	}
+}
@@ -0,0 +1,132 @@
+/*
+ * TerrainProfiler.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINPROFILER_H_
+#define TERRAINPROFILER_H_
+
+#include "engine/engine.h"
+
+class TerrainGenerator;
+class Layer;
+
+class TerrainRuleCounters {
+public:
+	uint64 calls;
+	uint64 earlyOuts;
+	uint64 nanos;
+};
+
+/**
+ * What one rule of the planet cost, see TerrainProfiler::getProfiles.
+ */
+class TerrainRuleProfile {
+public:
+	const static int LAYER = 0;
+	const static int BOUNDARY = 1;
+	const static int FILTER = 2;
+	const static int AFFECTOR = 3;
+
+	const void* rule;
+	int type;
+
+	// the owning layer, NULL for top level layers
+	Layer* parent;
+
+	String name;
+
+	uint64 calls;
+
+	/*
+	 * layer: boundaries or filters left nothing to apply
+	 * boundary: the sample was outside
+	 * filter: it cut the layer off, the filters after it didn't run
+	 */
+	uint64 earlyOuts;
+
+	// a layer's time includes its rules and child layers, selfNanos leaves
+	// them out. Rules have selfNanos == nanos
+	uint64 nanos;
+	uint64 selfNanos;
+
+	static const char* getTypeName(int type);
+};
+
+/**
+ * Per rule call counts, early outs and time, kept while a
+ * ProceduralTerrainAppearance walks its layer tree. The rules are registered
+ * once when the profiler is created, queries only bump counters. Every thread
+ * counts on its own, the totals are added up when asked for.
+ *
+ * Compiled programs and the grid paths have no per rule view, so the terrain
+ * walks the tree while profiling: the times are for that walk.
+ */
+class TerrainProfiler {
+	Vector<TerrainRuleProfile> rules;
+
+	// rule address to its index in rules
+	HashTable<uint64, int> indices;
+
+	ThreadLocal<TerrainRuleCounters*> threadCounters;
+
+	Mutex mutex;
+
+	// counters of every thread that has recorded, rules.size() + 1 each, the
+	// last one for rules added after the profiler was made
+	Vector<TerrainRuleCounters*> allCounters;
+
+public:
+	TerrainProfiler(TerrainGenerator* terrainGenerator);
+	~TerrainProfiler();
+
+	/**
+	 * Counts one call of rule that started at start, Time::currentNanoTime().
+	 */
+	inline void record(const void* rule, uint64 start, bool earlyOut) {
+		uint64 nanos = Time::currentNanoTime() - start;
+
+		TerrainRuleCounters* counters = getCounters(rule);
+
+		++counters->calls;
+		counters->earlyOuts += earlyOut;
+		counters->nanos += nanos;
+	}
+
+	/**
+	 * Totals over every thread, slowest self time first.
+	 */
+	void getProfiles(Vector<TerrainRuleProfile>& profiles);
+
+	/**
+	 * getProfiles as a table on System::out, the first lines only when lines > 0.
+	 * Percentages are of the time spent in the top level layers, self times
+	 * don't overlap so they add up to 100.
+	 */
+	void printReport(int lines = 0);
+
+	/**
+	 * Zeroes every counter. Not while queries are running.
+	 */
+	void reset();
+
+protected:
+	void addLayer(Layer* layer, Layer* parent);
+	void addRule(const void* rule, int type, Layer* parent, const String& name);
+
+	inline TerrainRuleCounters* getCounters(const void* rule) {
+		TerrainRuleCounters* counters = threadCounters.get();
+
+		if (counters == NULL)
+			counters = addThread();
+
+		int index = indices.get((uint64) (size_t) rule);
+
+		return &counters[index < 0 ? rules.size() : index];
+	}
+
+	TerrainRuleCounters* addThread();
+};
+
+#endif /* TERRAINPROFILER_H_ */
@@ -0,0 +1,393 @@
+/*
+ * TerrainProgram.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainProgram.h"
+#include "TerrainGenerator.h"
+#include "TerrainLayerIndex.h"
+#include "ProceduralTerrainAppearance.h"
+
+#include "layer/affectors.h"
+#include "layer/boundaries.h"
+#include "layer/filters.h"
+
+bool TerrainProgram::isNeeded(Layer* layer) {
+	if (affectorType == AffectorProceduralRule::ALL)
+		return true;
+
+	Vector<AffectorProceduralRule*>* affectors = layer->getAffectors();
+
+	for (int i = 0; i < affectors->size(); ++i) {
+		AffectorProceduralRule* affector = affectors->get(i);
+
+		if (affector->isEnabled() && (affector->getAffectorType() & affectorType))
+			return true;
+	}
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i) {
+		Layer* child = children->get(i);
+
+		if (child->isEnabled() && isNeeded(child))
+			return true;
+	}
+
+	return false;
+}
+
+int TerrainProgram::countInstructions(Layer* layer, int depth) {
+	if (depth > MAX_DEPTH)
+		return -1;
+
+	// LAYER, BOUNDARIES_END, FILTERS_END and END
+	int total = 4;
+
+	Vector<Boundary*>* boundaries = layer->getBoundaries();
+
+	for (int i = 0; i < boundaries->size(); ++i) {
+		if (boundaries->get(i)->isEnabled())
+			++total;
+	}
+
+	Vector<FilterProceduralRule*>* filters = layer->getFilters();
+
+	for (int i = 0; i < filters->size(); ++i) {
+		if (filters->get(i)->isEnabled())
+			++total;
+	}
+
+	Vector<AffectorProceduralRule*>* affectors = layer->getAffectors();
+
+	for (int i = 0; i < affectors->size(); ++i) {
+		AffectorProceduralRule* affector = affectors->get(i);
+
+		if (affector->isEnabled() && (affector->getAffectorType() & affectorType))
+			++total;
+	}
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i) {
+		Layer* child = children->get(i);
+
+		if (!child->isEnabled() || !isNeeded(child))
+			continue;
+
+		int childTotal = countInstructions(child, depth + 1);
+
+		if (childTotal < 0)
+			return -1;
+
+		total += childTotal;
+	}
+
+	return total;
+}
+
+TerrainInstruction* TerrainProgram::add(int op, int parameter) {
+	TerrainInstruction* instruction = &instructions[count++];
+
+	instruction->op = op;
+	instruction->parameter = parameter;
+	instruction->jump = 0;
+	instruction->layer = NULL;
+
+	return instruction;
+}
+
+bool TerrainProgram::compile(LayersGroup* layersGroup, int affectorType) {
+	delete [] instructions;
+	instructions = NULL;
+	count = 0;
+
+	this->affectorType = affectorType;
+
+	Vector<Layer*>* layers = layersGroup->getLayers();
+
+	int total = 0;
+
+	for (int i = 0; i < layers->size(); ++i) {
+		Layer* layer = layers->get(i);
+
+		if (!layer->isEnabled() || !isNeeded(layer))
+			continue;
+
+		int layerTotal = countInstructions(layer, 1);
+
+		if (layerTotal < 0)
+			return false;
+
+		total += layerTotal;
+	}
+
+	instructions = new TerrainInstruction[total];
+
+	for (int i = 0; i < layers->size(); ++i) {
+		Layer* layer = layers->get(i);
+
+		if (layer->isEnabled() && isNeeded(layer))
+			compileLayer(layer);
+	}
+
+	return true;
+}
+
+void TerrainProgram::compileLayer(Layer* layer) {
+	int start = count;
+
+	add(TerrainInstruction::LAYER, 0)->layer = layer;
+
+	Vector<Boundary*>* boundaries = layer->getBoundaries();
+	int firstBoundary = count;
+
+	for (int i = 0; i < boundaries->size(); ++i) {
+		Boundary* boundary = boundaries->get(i);
+
+		if (!boundary->isEnabled())
+			continue;
+
+		int op = TerrainInstruction::BOUNDARY;
+
+		if (dynamic_cast<BoundaryRectangle*>(boundary) != NULL)
+			op = TerrainInstruction::BOUNDARY_RECTANGLE;
+		else if (dynamic_cast<BoundaryCircle*>(boundary) != NULL)
+			op = TerrainInstruction::BOUNDARY_CIRCLE;
+		else if (dynamic_cast<BoundaryPolygon*>(boundary) != NULL)
+			op = TerrainInstruction::BOUNDARY_POLYGON;
+		else if (dynamic_cast<BoundaryPolyline*>(boundary) != NULL)
+			op = TerrainInstruction::BOUNDARY_POLYLINE;
+
+		add(op, boundary->getFeatheringType())->boundary = boundary;
+	}
+
+	int boundariesEnd = count;
+
+	// a full transform skips the remaining boundaries
+	for (int i = firstBoundary; i < boundariesEnd; ++i)
+		instructions[i].jump = boundariesEnd;
+
+	int flags = 0;
+
+	if (boundariesEnd == firstBoundary)
+		flags |= TerrainInstruction::NO_BOUNDARIES;
+
+	if (layer->invertBoundaries())
+		flags |= TerrainInstruction::INVERT;
+
+	add(TerrainInstruction::BOUNDARIES_END, flags);
+
+	Vector<FilterProceduralRule*>* filters = layer->getFilters();
+	int firstFilter = count;
+
+	for (int i = 0; i < filters->size(); ++i) {
+		FilterProceduralRule* filter = filters->get(i);
+
+		if (!filter->isEnabled())
+			continue;
+
+		int op = TerrainInstruction::FILTER;
+
+		if (dynamic_cast<FilterHeight*>(filter) != NULL)
+			op = TerrainInstruction::FILTER_HEIGHT;
+		else if (dynamic_cast<FilterFractal*>(filter) != NULL)
+			op = TerrainInstruction::FILTER_FRACTAL;
+		else if (dynamic_cast<FilterSlope*>(filter) != NULL)
+			op = TerrainInstruction::FILTER_SLOPE;
+		else if (dynamic_cast<FilterShader*>(filter) != NULL)
+			op = TerrainInstruction::FILTER_SHADER;
+
+		add(op, filter->getFeatheringType())->filter = filter;
+	}
+
+	int filtersEnd = count;
+
+	// a zero transform skips the remaining filters
+	for (int i = firstFilter; i < filtersEnd; ++i)
+		instructions[i].jump = filtersEnd;
+
+	add(TerrainInstruction::FILTERS_END, layer->invertFilters() ? TerrainInstruction::INVERT : 0);
+
+	Vector<AffectorProceduralRule*>* affectors = layer->getAffectors();
+
+	for (int i = 0; i < affectors->size(); ++i) {
+		AffectorProceduralRule* affector = affectors->get(i);
+
+		if (!affector->isEnabled() || !(affector->getAffectorType() & affectorType))
+			continue;
+
+		int op = TerrainInstruction::AFFECTOR;
+
+		if (dynamic_cast<AffectorHeightConstant*>(affector) != NULL)
+			op = TerrainInstruction::AFFECTOR_HEIGHT_CONSTANT;
+		else if (dynamic_cast<AffectorHeightFractal*>(affector) != NULL)
+			op = TerrainInstruction::AFFECTOR_HEIGHT_FRACTAL;
+		else if (dynamic_cast<AffectorHeightTerrace*>(affector) != NULL)
+			op = TerrainInstruction::AFFECTOR_HEIGHT_TERRACE;
+		else if (dynamic_cast<AffectorEnvironment*>(affector) != NULL)
+			op = TerrainInstruction::AFFECTOR_ENVIRONMENT;
+		else if (dynamic_cast<AffectorShaderConstant*>(affector) != NULL)
+			op = TerrainInstruction::AFFECTOR_SHADER_CONSTANT;
+		else if (dynamic_cast<AffectorColorConstant*>(affector) != NULL)
+			op = TerrainInstruction::AFFECTOR_COLOR_CONSTANT;
+
+		add(op, affector->getAffectorType())->affector = affector;
+	}
+
+	Vector<Layer*>* children = layer->getChildren();
+
+	for (int i = 0; i < children->size(); ++i) {
+		Layer* child = children->get(i);
+
+		if (child->isEnabled() && isNeeded(child))
+			compileLayer(child);
+	}
+
+	add(TerrainInstruction::END, 0);
+
+	// layers ruled out anywhere along the way continue after END
+	instructions[start].jump = count;
+	instructions[boundariesEnd].jump = count;
+	instructions[filtersEnd].jump = count;
+}
+
+void TerrainProgram::execute(float x, float y, float& baseValue, int affectorType, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int row, int column, const uint32* affectingLayers) {
+	// affector transform of every open layer, [0] for the top level
+	float affectorTransform[MAX_DEPTH + 1];
+	int depth = 0;
+
+	affectorTransform[0] = 1.0;
+
+	float transformValue = 0;
+	float result;
+
+	const TerrainInstruction* code = instructions;
+	int pc = 0;
+
+	while (pc < count) {
+		const TerrainInstruction& instruction = code[pc];
+
+		switch (instruction.op) {
+		case TerrainInstruction::LAYER:
+			if (!TerrainLayerIndex::contains(affectingLayers, instruction.layer)) {
+				pc = instruction.jump;
+				continue;
+			}
+
+			transformValue = 0;
+			++pc;
+			continue;
+
+		case TerrainInstruction::BOUNDARY:
+			result = instruction.boundary->process(x, y);
+			break;
+		case TerrainInstruction::BOUNDARY_RECTANGLE:
+			result = static_cast<BoundaryRectangle*>(instruction.boundary)->BoundaryRectangle::process(x, y);
+			break;
+		case TerrainInstruction::BOUNDARY_CIRCLE:
+			result = static_cast<BoundaryCircle*>(instruction.boundary)->BoundaryCircle::process(x, y);
+			break;
+		case TerrainInstruction::BOUNDARY_POLYGON:
+			result = static_cast<BoundaryPolygon*>(instruction.boundary)->BoundaryPolygon::process(x, y);
+			break;
+		case TerrainInstruction::BOUNDARY_POLYLINE:
+			result = static_cast<BoundaryPolyline*>(instruction.boundary)->BoundaryPolyline::process(x, y);
+			break;
+
+		case TerrainInstruction::BOUNDARIES_END:
+			if (instruction.parameter & TerrainInstruction::NO_BOUNDARIES)
+				transformValue = 1.0;
+
+			if (instruction.parameter & TerrainInstruction::INVERT)
+				transformValue = 1.0 - transformValue;
+
+			pc = transformValue != 0 ? pc + 1 : instruction.jump;
+			continue;
+
+		case TerrainInstruction::FILTER:
+			result = instruction.filter->process(x, y, transformValue, baseValue, terrainGenerator, chunk, row, column);
+			break;
+		case TerrainInstruction::FILTER_HEIGHT:
+			result = static_cast<FilterHeight*>(instruction.filter)->FilterHeight::process(x, y, transformValue, baseValue, terrainGenerator, chunk, row, column);
+			break;
+		case TerrainInstruction::FILTER_FRACTAL:
+			result = static_cast<FilterFractal*>(instruction.filter)->FilterFractal::process(x, y, transformValue, baseValue, terrainGenerator, chunk, row, column);
+			break;
+		case TerrainInstruction::FILTER_SLOPE:
+			result = static_cast<FilterSlope*>(instruction.filter)->FilterSlope::process(x, y, transformValue, baseValue, terrainGenerator, chunk, row, column);
+			break;
+		case TerrainInstruction::FILTER_SHADER:
+			result = static_cast<FilterShader*>(instruction.filter)->FilterShader::process(x, y, transformValue, baseValue, terrainGenerator, chunk, row, column);
+			break;
+
+		case TerrainInstruction::FILTERS_END:
+			if (instruction.parameter & TerrainInstruction::INVERT)
+				transformValue = 1.0 - transformValue;
+
+			if (transformValue == 0) {
+				pc = instruction.jump;
+				continue;
+			}
+
+			affectorTransform[depth + 1] = transformValue * affectorTransform[depth];
+			++depth;
+			++pc;
+			continue;
+
+		case TerrainInstruction::END:
+			--depth;
+			++pc;
+			continue;
+
+		default:
+			// affectors
+			if (instruction.parameter & affectorType) {
+				float transform = affectorTransform[depth];
+
+				switch (instruction.op) {
+				case TerrainInstruction::AFFECTOR_HEIGHT_CONSTANT:
+					static_cast<AffectorHeightConstant*>(instruction.affector)->AffectorHeightConstant::process(x, y, transform, baseValue, terrainGenerator, chunk, row, column);
+					break;
+				case TerrainInstruction::AFFECTOR_HEIGHT_FRACTAL:
+					static_cast<AffectorHeightFractal*>(instruction.affector)->AffectorHeightFractal::process(x, y, transform, baseValue, terrainGenerator, chunk, row, column);
+					break;
+				case TerrainInstruction::AFFECTOR_HEIGHT_TERRACE:
+					static_cast<AffectorHeightTerrace*>(instruction.affector)->AffectorHeightTerrace::process(x, y, transform, baseValue, terrainGenerator, chunk, row, column);
+					break;
+				case TerrainInstruction::AFFECTOR_ENVIRONMENT:
+					static_cast<AffectorEnvironment*>(instruction.affector)->AffectorEnvironment::process(x, y, transform, baseValue, terrainGenerator, chunk, row, column);
+					break;
+				case TerrainInstruction::AFFECTOR_SHADER_CONSTANT:
+					static_cast<AffectorShaderConstant*>(instruction.affector)->AffectorShaderConstant::process(x, y, transform, baseValue, terrainGenerator, chunk, row, column);
+					break;
+				case TerrainInstruction::AFFECTOR_COLOR_CONSTANT:
+					static_cast<AffectorColorConstant*>(instruction.affector)->AffectorColorConstant::process(x, y, transform, baseValue, terrainGenerator, chunk, row, column);
+					break;
+				default:
+					instruction.affector->process(x, y, transform, baseValue, terrainGenerator, chunk, row, column);
+					break;
+				}
+			}
+
+			++pc;
+			continue;
+		}
+
+		// boundaries and filters end up here with their raw result
+		result = ProceduralTerrainAppearance::calculateFeathering(result, instruction.parameter);
+
+		if (instruction.op < TerrainInstruction::BOUNDARIES_END) {
+			if (result > transformValue)
+				transformValue = result;
+
+			pc = transformValue >= 1 ? instruction.jump : pc + 1;
+		} else {
+			if (transformValue > result)
+				transformValue = result;
+
+			pc = transformValue == 0 ? instruction.jump : pc + 1;
+		}
+	}
+}
@@ -0,0 +1,142 @@
+/*
+ * TerrainProgram.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINPROGRAM_H_
+#define TERRAINPROGRAM_H_
+
+#include "engine/engine.h"
+
+class Layer;
+class LayersGroup;
+class Boundary;
+class AffectorProceduralRule;
+class FilterProceduralRule;
+class TerrainGenerator;
+class TerrainChunk;
+
+/**
+ * One step of a compiled layer tree. Rules of the common types get their
+ * own op code so the interpreter calls them without a virtual dispatch,
+ * anything else goes through the generic op of its kind.
+ */
+class TerrainInstruction {
+public:
+	enum {
+		// enters a layer, jump is past its END when the index rules it out
+		LAYER,
+
+		BOUNDARY,
+		BOUNDARY_RECTANGLE,
+		BOUNDARY_CIRCLE,
+		BOUNDARY_POLYGON,
+		BOUNDARY_POLYLINE,
+
+		// jump is past the layer's END when the transform is 0
+		BOUNDARIES_END,
+
+		FILTER,
+		FILTER_HEIGHT,
+		FILTER_FRACTAL,
+		FILTER_SLOPE,
+		FILTER_SHADER,
+
+		// pushes the layer's transform, same jump as BOUNDARIES_END
+		FILTERS_END,
+
+		AFFECTOR,
+		AFFECTOR_HEIGHT_CONSTANT,
+		AFFECTOR_HEIGHT_FRACTAL,
+		AFFECTOR_HEIGHT_TERRACE,
+		AFFECTOR_ENVIRONMENT,
+		AFFECTOR_SHADER_CONSTANT,
+		AFFECTOR_COLOR_CONSTANT,
+
+		// pops the layer's transform
+		END
+	};
+
+	// BOUNDARIES_END flags
+	const static int NO_BOUNDARIES = 1;
+	const static int INVERT = 2;
+
+	int op;
+
+	// feathering type, affector type or flags depending on op
+	int parameter;
+
+	// instruction to continue at when the op skips ahead
+	int jump;
+
+	union {
+		Layer* layer;
+		Boundary* boundary;
+		FilterProceduralRule* filter;
+		AffectorProceduralRule* affector;
+	};
+};
+
+/**
+ * The enabled part of the layer tree flattened into one instruction array,
+ * executed per sample by a loop instead of the recursive processTerrain walk.
+ * Same results as the walk, the program only holds pointers to the rules so
+ * it has to be compiled again whenever the layers change.
+ *
+ * A program compiled for one affector type leaves out the layers that have
+ * no such affector anywhere below them, e.g. the many shader and flora only
+ * layers when asking for heights. Only valid without a chunk: filters then
+ * never touch the base value, so skipping those layers changes nothing.
+ */
+class TerrainProgram {
+	TerrainInstruction* instructions;
+	int count;
+
+public:
+	// deepest layer nesting the interpreter keeps transforms for
+	const static int MAX_DEPTH = 64;
+
+	TerrainProgram() {
+		instructions = NULL;
+		count = 0;
+		affectorType = 0;
+	}
+
+	~TerrainProgram() {
+		delete [] instructions;
+	}
+
+	/**
+	 * Compiles the layers for queries of affectorType, AffectorProceduralRule::ALL
+	 * keeps every enabled layer. Returns false, leaving the program empty, when
+	 * the tree is nested deeper than MAX_DEPTH.
+	 */
+	bool compile(LayersGroup* layersGroup, int affectorType);
+
+	/**
+	 * Runs every layer for one sample, as processTerrain does for each
+	 * enabled top level layer in turn. affectorType must be the type the
+	 * program was compiled for, or any type for an ALL program.
+	 */
+	void execute(float x, float y, float& baseValue, int affectorType, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int row, int column, const uint32* affectingLayers);
+
+	inline int size() {
+		return count;
+	}
+
+	inline int getAffectorType() {
+		return affectorType;
+	}
+
+protected:
+	int affectorType;
+
+	bool isNeeded(Layer* layer);
+	int countInstructions(Layer* layer, int depth);
+	void compileLayer(Layer* layer);
+
+	TerrainInstruction* add(int op, int parameter);
+};
+
+#endif /* TERRAINPROGRAM_H_ */
@@ -0,0 +1,108 @@
+/*
+ * TerrainRegion.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINREGION_H_
+#define TERRAINREGION_H_
+
+#include "engine/engine.h"
+
+/**
+ * Part of the terrain an edit can reach: nothing, an axis aligned box or the
+ * whole terrain. Boxes only grow, adding two gives the box around both.
+ */
+class TerrainRegion {
+	bool bounded;
+	bool empty;
+
+	float minX, minY;
+	float maxX, maxY;
+
+public:
+	TerrainRegion() {
+		bounded = true;
+		empty = true;
+
+		minX = minY = maxX = maxY = 0;
+	}
+
+	inline void add(float minX, float minY, float maxX, float maxY) {
+		if (!bounded)
+			return;
+
+		if (empty) {
+			this->minX = minX;
+			this->minY = minY;
+			this->maxX = maxX;
+			this->maxY = maxY;
+
+			empty = false;
+			return;
+		}
+
+		if (minX < this->minX)
+			this->minX = minX;
+
+		if (minY < this->minY)
+			this->minY = minY;
+
+		if (maxX > this->maxX)
+			this->maxX = maxX;
+
+		if (maxY > this->maxY)
+			this->maxY = maxY;
+	}
+
+	inline void add(const TerrainRegion& region) {
+		if (!region.bounded)
+			addEverywhere();
+		else if (!region.empty)
+			add(region.minX, region.minY, region.maxX, region.maxY);
+	}
+
+	inline void addEverywhere() {
+		bounded = false;
+		empty = false;
+	}
+
+	inline bool isEmpty() const {
+		return empty;
+	}
+
+	inline bool isEverywhere() const {
+		return !bounded;
+	}
+
+	/**
+	 * Whether the closed box min..max overlaps the region.
+	 */
+	inline bool intersects(float minX, float minY, float maxX, float maxY) const {
+		if (empty)
+			return false;
+
+		if (!bounded)
+			return true;
+
+		return minX <= this->maxX && maxX >= this->minX && minY <= this->maxY && maxY >= this->minY;
+	}
+
+	inline float getMinX() const {
+		return minX;
+	}
+
+	inline float getMinY() const {
+		return minY;
+	}
+
+	inline float getMaxX() const {
+		return maxX;
+	}
+
+	inline float getMaxY() const {
+		return maxY;
+	}
+};
+
+#endif /* TERRAINREGION_H_ */
@@ -0,0 +1,50 @@
+/*
+ * TerrainSample.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINSAMPLE_H_
+#define TERRAINSAMPLE_H_
+
+#include "engine/engine.h"
+
+/**
+ * Everything the layers say about one point, filled in by a single traversal.
+ */
+class TerrainSample {
+public:
+	enum {
+		HEIGHT,
+		ENVIRONMENT,
+		SHADER,
+		COLOR,
+		FLORA,
+		CHANNELS
+	};
+
+	// what getHeight returns
+	float height;
+
+	// what getEnvironmentID returns
+	int environmentId;
+
+	// id of the family getShaderFamily(x, y) returns
+	int shaderFamilyId;
+
+	// as stored in TerrainChunk, 0xFFFFFFFF unless a color affector applies
+	uint32 color;
+
+	// collidable flora family, 0 for none
+	int floraFamilyId;
+
+	TerrainSample() {
+		height = 0;
+		environmentId = 0;
+		shaderFamilyId = 0;
+		color = 0xFFFFFFFF;
+		floraFamilyId = 0;
+	}
+};
+
+#endif /* TERRAINSAMPLE_H_ */
@@ -0,0 +1,136 @@
+/*
+ * TerrainWaterIndex.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainWaterIndex.h"
+
+// boundaries compare in float, keep a little slack around their boxes
+static const float BOUNDS_MARGIN = 1.0f;
+
+TerrainWaterIndex::TerrainWaterIndex() {
+	originX = 0;
+	originY = 0;
+	inverseCellSize = 0;
+
+	boundaries = NULL;
+	boundaryCount = 0;
+
+	cellStart = NULL;
+	cellBoundaries = NULL;
+}
+
+TerrainWaterIndex::~TerrainWaterIndex() {
+	clear();
+}
+
+void TerrainWaterIndex::clear() {
+	delete [] boundaries;
+	boundaries = NULL;
+
+	boundaryCount = 0;
+
+	delete [] cellStart;
+	cellStart = NULL;
+
+	delete [] cellBoundaries;
+	cellBoundaries = NULL;
+}
+
+bool TerrainWaterIndex::getCells(Boundary* boundary, int& minColumn, int& minRow, int& maxColumn, int& maxRow) {
+	minColumn = 0;
+	minRow = 0;
+	maxColumn = CELLS_PER_SIDE - 1;
+	maxRow = CELLS_PER_SIDE - 1;
+
+	float minX, minY, maxX, maxY;
+
+	if (!boundary->getBounds(minX, minY, maxX, maxY))
+		return true;
+
+	// cells are picked with the same arithmetic as the lookups so every
+	// point inside the box finds the boundary
+	float column0 = (minX - BOUNDS_MARGIN - originX) * inverseCellSize;
+	float column1 = (maxX + BOUNDS_MARGIN - originX) * inverseCellSize;
+	float row0 = (minY - BOUNDS_MARGIN - originY) * inverseCellSize;
+	float row1 = (maxY + BOUNDS_MARGIN - originY) * inverseCellSize;
+
+	if (!(column0 <= column1 && row0 <= row1))
+		return false;
+
+	if (column1 < 0 || row1 < 0 || column0 >= CELLS_PER_SIDE || row0 >= CELLS_PER_SIDE)
+		return false;
+
+	if (column0 > 0)
+		minColumn = (int) column0;
+
+	if (column1 < CELLS_PER_SIDE)
+		maxColumn = (int) column1;
+
+	if (row0 > 0)
+		minRow = (int) row0;
+
+	if (row1 < CELLS_PER_SIDE)
+		maxRow = (int) row1;
+
+	return true;
+}
+
+void TerrainWaterIndex::build(Vector<Boundary*>* waterBoundaries, float terrainSize) {
+	clear();
+
+	if (!(terrainSize > 0))
+		return;
+
+	originX = -terrainSize / 2;
+	originY = -terrainSize / 2;
+	inverseCellSize = CELLS_PER_SIDE / terrainSize;
+
+	boundaryCount = waterBoundaries->size();
+	boundaries = new Boundary*[boundaryCount];
+
+	for (int i = 0; i < boundaryCount; ++i)
+		boundaries[i] = waterBoundaries->get(i);
+
+	const int cells = CELLS_PER_SIDE * CELLS_PER_SIDE;
+
+	cellStart = new int[cells + 1];
+	memset(cellStart, 0, (cells + 1) * sizeof(int));
+
+	// count first, cellStart[c + 1] holds the size of cell c for now
+	for (int i = 0; i < boundaryCount; ++i) {
+		int minColumn, minRow, maxColumn, maxRow;
+
+		if (!getCells(boundaries[i], minColumn, minRow, maxColumn, maxRow))
+			continue;
+
+		for (int row = minRow; row <= maxRow; ++row) {
+			for (int column = minColumn; column <= maxColumn; ++column)
+				++cellStart[row * CELLS_PER_SIDE + column + 1];
+		}
+	}
+
+	for (int cell = 0; cell < cells; ++cell)
+		cellStart[cell + 1] += cellStart[cell];
+
+	cellBoundaries = new int[cellStart[cells] > 0 ? cellStart[cells] : 1];
+
+	int* fill = new int[cells];
+	memcpy(fill, cellStart, cells * sizeof(int));
+
+	// boundaries go in in order, so every cell lists them in order
+	for (int i = 0; i < boundaryCount; ++i) {
+		int minColumn, minRow, maxColumn, maxRow;
+
+		if (!getCells(boundaries[i], minColumn, minRow, maxColumn, maxRow))
+			continue;
+
+		for (int row = minRow; row <= maxRow; ++row) {
+			for (int column = minColumn; column <= maxColumn; ++column)
+				cellBoundaries[fill[row * CELLS_PER_SIDE + column]++] = i;
+		}
+	}
+
+	delete [] fill;
+}
@@ -0,0 +1,95 @@
+/*
+ * TerrainWaterIndex.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINWATERINDEX_H_
+#define TERRAINWATERINDEX_H_
+
+#include "engine/engine.h"
+
+#include "layer/boundaries/Boundary.h"
+
+/**
+ * Static grid over the terrain, built once at load, listing for every cell the
+ * water boundaries whose box touches it. The lists keep the order the
+ * boundaries were inserted in, so the first boundary containing a point is
+ * the same one a scan of all of them would find.
+ *
+ * Points outside the terrain check every boundary.
+ */
+class TerrainWaterIndex {
+	float originX, originY;
+	float inverseCellSize;
+
+	Boundary** boundaries;
+	int boundaryCount;
+
+	// the boundaries of cell c are cellBoundaries[cellStart[c]] up to
+	// cellBoundaries[cellStart[c + 1]], as indices into boundaries
+	int* cellStart;
+	int* cellBoundaries;
+
+public:
+	const static int CELLS_PER_SIDE = 64;
+
+	TerrainWaterIndex();
+	~TerrainWaterIndex();
+
+	/**
+	 * Fills the cells covering -terrainSize / 2 .. terrainSize / 2 on both axes.
+	 */
+	void build(Vector<Boundary*>* waterBoundaries, float terrainSize);
+
+	void clear();
+
+	inline bool isBuilt() {
+		return cellStart != NULL;
+	}
+
+	/**
+	 * First boundary containing the point, NULL for none.
+	 */
+	inline Boundary* getBoundary(float x, float y) {
+		int cell = getCell(x, y);
+
+		if (cell < 0) {
+			for (int i = 0; i < boundaryCount; ++i) {
+				if (boundaries[i]->containsPoint(x, y))
+					return boundaries[i];
+			}
+
+			return NULL;
+		}
+
+		for (int i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+			Boundary* boundary = boundaries[cellBoundaries[i]];
+
+			if (boundary->containsPoint(x, y))
+				return boundary;
+		}
+
+		return NULL;
+	}
+
+protected:
+	inline int getCell(float x, float y) {
+		float column = (x - originX) * inverseCellSize;
+		float row = (y - originY) * inverseCellSize;
+
+		// written so NaN fails too
+		if (!(column >= 0 && column < CELLS_PER_SIDE && row >= 0 && row < CELLS_PER_SIDE))
+			return -1;
+
+		return (int) row * CELLS_PER_SIDE + (int) column;
+	}
+
+	/**
+	 * Cells touched by the boundary's box, all of them when it has none.
+	 * False when the box misses the grid.
+	 */
+	bool getCells(Boundary* boundary, int& minColumn, int& minRow, int& maxColumn, int& maxRow);
+};
+
+#endif /* TERRAINWATERINDEX_H_ */
@@ -0,0 +1,129 @@
+/*
+ * TerrainWorkerPool.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "TerrainWorkerPool.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+TerrainWorkerPool::TerrainWorkerPool(int numThreads) {
+	if (numThreads <= 0)
+		numThreads = getNumberOfProcessors();
+
+	this->numThreads = numThreads;
+
+	task = NULL;
+}
+
+int TerrainWorkerPool::getNumberOfProcessors() {
+#ifndef _WIN32
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+
+	long count = info.dwNumberOfProcessors;
+#endif
+
+	if (count < 1)
+		count = 1;
+
+	return (int) count;
+}
+
+void TerrainWorkerPool::execute(TerrainTask* task, int count) {
+	if (count <= 0)
+		return;
+
+	int threads = numThreads;
+
+	if (threads > count)
+		threads = count;
+
+	if (threads <= 1) {
+		for (int i = 0; i < count; ++i)
+			task->run(i);
+
+		return;
+	}
+
+	this->task = task;
+
+	for (int i = 0; i < threads; ++i) {
+		WorkQueue* queue = new WorkQueue();
+		queue->begin = count * i / threads;
+		queue->end = count * (i + 1) / threads;
+
+		queues.add(queue);
+	}
+
+	Vector<Worker*> workers;
+
+	for (int i = 1; i < threads; ++i) {
+		Worker* worker = new Worker(this, i);
+		worker->start();
+
+		workers.add(worker);
+	}
+
+	work(0);
+
+	for (int i = 0; i < workers.size(); ++i) {
+		Worker* worker = workers.get(i);
+		worker->join();
+
+		delete worker;
+	}
+
+	for (int i = 0; i < queues.size(); ++i)
+		delete queues.get(i);
+
+	queues.removeAll();
+
+	this->task = NULL;
+}
+
+int TerrainWorkerPool::nextIndex(int id) {
+	WorkQueue* own = queues.get(id);
+
+	own->mutex.lock();
+
+	if (own->begin < own->end) {
+		int index = own->begin++;
+		own->mutex.unlock();
+
+		return index;
+	}
+
+	own->mutex.unlock();
+
+	for (int i = 1; i < queues.size(); ++i) {
+		WorkQueue* victim = queues.get((id + i) % queues.size());
+
+		victim->mutex.lock();
+
+		if (victim->begin < victim->end) {
+			int index = --victim->end;
+			victim->mutex.unlock();
+
+			return index;
+		}
+
+		victim->mutex.unlock();
+	}
+
+	return -1;
+}
+
+void TerrainWorkerPool::work(int id) {
+	int index;
+
+	while ((index = nextIndex(id)) != -1)
+		task->run(index);
+}
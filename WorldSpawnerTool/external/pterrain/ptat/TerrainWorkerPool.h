@@ -0,0 +1,85 @@
+/*
+ * TerrainWorkerPool.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef TERRAINWORKERPOOL_H_
+#define TERRAINWORKERPOOL_H_
+
+#include "engine/engine.h"
+
+/**
+ * One unit of work, run(index) is called once for every index in the batch.
+ */
+class TerrainTask {
+public:
+	virtual ~TerrainTask() {
+
+	}
+
+	virtual void run(int index) = 0;
+};
+
+/**
+ * Runs a batch of independent tasks on several threads. Every thread starts with an
+ * even share of the indices and steals from the back of the others' shares once its
+ * own runs out, so uneven tasks (empty ocean chunks next to dense cities) still keep
+ * all cores busy.
+ */
+class TerrainWorkerPool {
+	class WorkQueue {
+	public:
+		Mutex mutex;
+		int begin;
+		int end;
+
+		WorkQueue() {
+			begin = 0;
+			end = 0;
+		}
+	};
+
+	class Worker : public Thread {
+		TerrainWorkerPool* pool;
+		int id;
+
+	public:
+		Worker(TerrainWorkerPool* pool, int id) {
+			this->pool = pool;
+			this->id = id;
+		}
+
+		void run() {
+			pool->work(id);
+		}
+	};
+
+	int numThreads;
+
+	TerrainTask* task;
+	Vector<WorkQueue*> queues;
+
+	int nextIndex(int id);
+	void work(int id);
+
+public:
+	/**
+	 * @param numThreads threads to use, 0 for one per processor
+	 */
+	TerrainWorkerPool(int numThreads = 0);
+
+	/**
+	 * Calls task->run(i) for every i in [0, count) and returns once all have finished.
+	 * The calling thread takes part in the work.
+	 */
+	void execute(TerrainTask* task, int count);
+
+	inline int getNumThreads() {
+		return numThreads;
+	}
+
+	static int getNumberOfProcessors();
+};
+
+#endif /* TERRAINWORKERPOOL_H_ */
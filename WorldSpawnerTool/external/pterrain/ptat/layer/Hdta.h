@@ -50,7 +50,9 @@ public:
 		}
 	}
 
-
+	inline Vector<Segment*>* getSegments() {
+		return &sgmts;
+	}
 };
 
 
@@ -37,11 +37,15 @@ class Layer : public TemplateVariable<'LAYR'> {
 	int boundariesFlag;
 	int filterFlag;
 
+	// position in the depth first walk of the layer tree, see TerrainLayerIndex
+	int index;
+
 public:
 	Layer(Layer* par = NULL) {
 		parent = par;
 		boundariesFlag = 0;
 		filterFlag = 0;
+		index = 0;
 	}
 
 	~Layer();
@@ -89,6 +93,14 @@ public:
 		return infoHeader.isEnabled();
 	}
 
+	inline int getIndex() {
+		return index;
+	}
+
+	inline void setIndex(int index) {
+		this->index = index;
+	}
+
 	inline String& getDescription() {
 		return infoHeader.getDescription();
 	}
@@ -0,0 +1,23 @@
+/*
+ * Point2D.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef POINT2D_H_
+#define POINT2D_H_
+
+class Point2D  {
+public:
+	float x, y;
+
+	inline float getX() {
+		return x;
+	}
+
+	inline float getY() {
+		return y;
+	}
+};
+
+#endif /* POINT2D_H_ */
@@ -0,0 +1,222 @@
+/*
+ * PolylineSegments.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "PolylineSegments.h"
+
+// segments compare in float, keep a little slack around their boxes
+static const float BOUNDS_MARGIN = 1.0f;
+
+PolylineSegments::PolylineSegments() {
+	points = NULL;
+	pointCount = 0;
+
+	segments = NULL;
+	segmentCount = 0;
+
+	radius = 0;
+
+	originX = 0;
+	originY = 0;
+	inverseCellSize = 0;
+	columns = 0;
+	rows = 0;
+
+	cellStart = NULL;
+	cellSegments = NULL;
+}
+
+PolylineSegments::~PolylineSegments() {
+	clear();
+}
+
+void PolylineSegments::clear() {
+	addedPoints.removeAll();
+	addedSegments.removeAll();
+
+	delete [] points;
+	points = NULL;
+	pointCount = 0;
+
+	delete [] segments;
+	segments = NULL;
+	segmentCount = 0;
+
+	delete [] cellStart;
+	cellStart = NULL;
+
+	delete [] cellSegments;
+	cellSegments = NULL;
+}
+
+void PolylineSegments::addPoint(float x, float y, float height) {
+	addedPoints.add(x);
+	addedPoints.add(y);
+	addedPoints.add(height);
+}
+
+void PolylineSegments::addSegments(int count) {
+	int last = addedPoints.size() / 3 - 1;
+	int first = last - count + 1;
+
+	if (count == 1) {
+		addedSegments.add(first);
+		addedSegments.add(first);
+	}
+
+	for (int i = first + 1; i <= last; ++i) {
+		addedSegments.add(i - 1);
+		addedSegments.add(i);
+	}
+}
+
+void PolylineSegments::add(Vector<Point2D*>* points) {
+	for (int i = 0; i < points->size(); ++i) {
+		Point2D* point = points->get(i);
+
+		addPoint(point->x, point->y, 0);
+	}
+
+	addSegments(points->size());
+}
+
+void PolylineSegments::add(Vector<Point3D*>* points) {
+	for (int i = 0; i < points->size(); ++i) {
+		Point3D* point = points->get(i);
+
+		addPoint(point->x, point->y, point->z);
+	}
+
+	addSegments(points->size());
+}
+
+void PolylineSegments::getCells(int segment, int& minColumn, int& minRow, int& maxColumn, int& maxRow) {
+	const float* start = points + 3 * segments[2 * segment];
+	const float* end = points + 3 * segments[2 * segment + 1];
+
+	float reach = radius + BOUNDS_MARGIN;
+
+	// same arithmetic as getCell so every point within radius finds the segment
+	float column0 = ((start[0] < end[0] ? start[0] : end[0]) - reach - originX) * inverseCellSize;
+	float column1 = ((start[0] < end[0] ? end[0] : start[0]) + reach - originX) * inverseCellSize;
+	float row0 = ((start[1] < end[1] ? start[1] : end[1]) - reach - originY) * inverseCellSize;
+	float row1 = ((start[1] < end[1] ? end[1] : start[1]) + reach - originY) * inverseCellSize;
+
+	minColumn = column0 > 0 ? (int) column0 : 0;
+	minRow = row0 > 0 ? (int) row0 : 0;
+	maxColumn = column1 < columns ? (int) column1 : columns - 1;
+	maxRow = row1 < rows ? (int) row1 : rows - 1;
+}
+
+void PolylineSegments::build(float radius) {
+	delete [] points;
+	delete [] segments;
+	delete [] cellStart;
+	delete [] cellSegments;
+
+	points = NULL;
+	segments = NULL;
+	cellStart = NULL;
+	cellSegments = NULL;
+
+	this->radius = radius > 0 ? radius : 0;
+
+	pointCount = addedPoints.size() / 3;
+	segmentCount = addedSegments.size() / 2;
+
+	if (segmentCount == 0)
+		return;
+
+	points = new float[pointCount * 3];
+
+	for (int i = 0; i < pointCount * 3; ++i)
+		points[i] = addedPoints.get(i);
+
+	segments = new int[segmentCount * 2];
+
+	for (int i = 0; i < segmentCount * 2; ++i)
+		segments[i] = addedSegments.get(i);
+
+	float minX = points[0], minY = points[1];
+	float maxX = minX, maxY = minY;
+
+	for (int i = 1; i < pointCount; ++i) {
+		float x = points[3 * i], y = points[3 * i + 1];
+
+		if (x < minX)
+			minX = x;
+
+		if (x > maxX)
+			maxX = x;
+
+		if (y < minY)
+			minY = y;
+
+		if (y > maxY)
+			maxY = y;
+	}
+
+	float reach = this->radius + BOUNDS_MARGIN;
+
+	originX = minX - reach;
+	originY = minY - reach;
+
+	float width = maxX - minX + 2 * reach;
+	float height = maxY - minY + 2 * reach;
+
+	// cells about as wide as a query reaches, at most MAX_CELLS_PER_SIDE a side
+	float longest = width > height ? width : height;
+	float cellSize = longest / MAX_CELLS_PER_SIDE;
+
+	if (cellSize < reach)
+		cellSize = reach;
+
+	inverseCellSize = 1.0f / cellSize;
+
+	columns = (int) (width * inverseCellSize) + 1;
+	rows = (int) (height * inverseCellSize) + 1;
+
+	if (columns > MAX_CELLS_PER_SIDE)
+		columns = MAX_CELLS_PER_SIDE;
+
+	if (rows > MAX_CELLS_PER_SIDE)
+		rows = MAX_CELLS_PER_SIDE;
+
+	int cells = columns * rows;
+
+	cellStart = new int[cells + 1];
+	memset(cellStart, 0, (cells + 1) * sizeof(int));
+
+	// count first, cellStart[c + 1] holds the size of cell c for now
+	for (int i = 0; i < segmentCount; ++i) {
+		int minColumn, minRow, maxColumn, maxRow;
+		getCells(i, minColumn, minRow, maxColumn, maxRow);
+
+		for (int row = minRow; row <= maxRow; ++row) {
+			for (int column = minColumn; column <= maxColumn; ++column)
+				++cellStart[row * columns + column + 1];
+		}
+	}
+
+	for (int cell = 0; cell < cells; ++cell)
+		cellStart[cell + 1] += cellStart[cell];
+
+	cellSegments = new int[cellStart[cells] > 0 ? cellStart[cells] : 1];
+
+	int* fill = new int[cells];
+	memcpy(fill, cellStart, cells * sizeof(int));
+
+	for (int i = 0; i < segmentCount; ++i) {
+		int minColumn, minRow, maxColumn, maxRow;
+		getCells(i, minColumn, minRow, maxColumn, maxRow);
+
+		for (int row = minRow; row <= maxRow; ++row) {
+			for (int column = minColumn; column <= maxColumn; ++column)
+				cellSegments[fill[row * columns + column]++] = i;
+		}
+	}
+
+	delete [] fill;
+}
@@ -0,0 +1,164 @@
+/*
+ * PolylineSegments.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef POLYLINESEGMENTS_H_
+#define POLYLINESEGMENTS_H_
+
+#include "engine/engine.h"
+
+#include "Point2D.h"
+#include "Segment.h"
+
+/**
+ * Segments of one or more polylines with a grid over them, so the nearest
+ * segment to a point is found among the few close by instead of all of
+ * them. Points may carry a height, interpolated along the segments.
+ *
+ * Polylines are added first, then build() makes the grid for queries
+ * reaching at most radius away from the lines.
+ */
+class PolylineSegments {
+	// points and segments as added, copied into the arrays below by build()
+	Vector<float> addedPoints;
+	Vector<int> addedSegments;
+
+	// x, y and height of every point
+	float* points;
+	int pointCount;
+
+	// segment s runs from point segments[2 * s] to segments[2 * s + 1],
+	// the same point for a polyline of a single point
+	int* segments;
+	int segmentCount;
+
+	float radius;
+
+	float originX, originY;
+	float inverseCellSize;
+	int columns, rows;
+
+	// the segments of cell c are cellSegments[cellStart[c]] up to
+	// cellSegments[cellStart[c + 1]]
+	int* cellStart;
+	int* cellSegments;
+
+public:
+	const static int MAX_CELLS_PER_SIDE = 64;
+
+	PolylineSegments();
+	~PolylineSegments();
+
+	void add(Vector<Point2D*>* points);
+
+	/**
+	 * Point3D keeps the height in z.
+	 */
+	void add(Vector<Point3D*>* points);
+
+	void build(float radius);
+
+	void clear();
+
+	inline int getSegmentCount() {
+		return segmentCount;
+	}
+
+	/**
+	 * Smallest squared distance from the point to a vertex or a segment,
+	 * starting from limit, which must be at most radius squared. Same
+	 * arithmetic as the scan in BoundaryPolyline::process.
+	 *
+	 * height, when not NULL, is set to the height of the nearest point
+	 * found and left alone when nothing is closer than limit.
+	 */
+	inline double getDistanceSquared(float x, float y, double limit, float* height = NULL) {
+		int cell = getCell(x, y);
+
+		if (cell < 0)
+			return limit;
+
+		double best = limit;
+
+		for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+			int segment = cellSegments[k];
+
+			const float* start = points + 3 * segments[2 * segment];
+			const float* end = points + 3 * segments[2 * segment + 1];
+
+			float startX = start[0], startY = start[1];
+			float endX = end[0], endY = end[1];
+
+			double v20 = y - startY;
+			double v19 = v20 * v20 + (x - startX) * (x - startX);
+
+			if (v19 < best) {
+				best = v19;
+
+				if (height != NULL)
+					*height = start[2];
+			}
+
+			v20 = y - endY;
+			v19 = v20 * v20 + (x - endX) * (x - endX);
+
+			if (v19 < best) {
+				best = v19;
+
+				if (height != NULL)
+					*height = end[2];
+			}
+
+			double v35 = endX - startX;
+			double v24 = endY - startY;
+			double v36 = ((y - startY) * v24 + (x - startX) * v35) / (v24 * v24 + v35 * v35);
+
+			if (v36 >= 0.0 && v36 <= 1.0) {
+				double v26 = x - (v35 * v36 + startX);
+				double v27 = y - (v24 * v36 + startY);
+				double v25 = v27 * v27 + v26 * v26;
+
+				if (v25 < best) {
+					best = v25;
+
+					if (height != NULL) {
+						*height = start[2] + (end[2] - start[2]) * v36;
+					}
+				}
+			}
+		}
+
+		return best;
+	}
+
+protected:
+	inline int getCell(float x, float y) {
+		if (cellStart == NULL)
+			return -1;
+
+		float column = (x - originX) * inverseCellSize;
+		float row = (y - originY) * inverseCellSize;
+
+		// written so NaN fails too
+		if (!(column >= 0 && column < columns && row >= 0 && row < rows))
+			return -1;
+
+		return (int) row * columns + (int) column;
+	}
+
+	void addPoint(float x, float y, float height);
+
+	/**
+	 * Segments joining the count points added last, in order.
+	 */
+	void addSegments(int count);
+
+	/**
+	 * Cells within radius of the segment's box.
+	 */
+	void getCells(int segment, int& minColumn, int& minRow, int& maxColumn, int& maxRow);
+};
+
+#endif /* POLYLINESEGMENTS_H_ */
@@ -48,6 +48,10 @@ public:
 			sgmts.add(sgmt);
 		}
 	}
+
+	inline Vector<Segment*>* getSegments() {
+		return &sgmts;
+	}
 };
 
 
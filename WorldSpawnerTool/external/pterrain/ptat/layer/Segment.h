@@ -41,6 +41,10 @@ public:
 		iffStream->closeChunk('SGMT');
 	}
 
+	inline Vector<Point3D*>* getPositions() {
+		return &positions;
+	}
+
 
 };
 
@@ -101,6 +101,10 @@ public:
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 
@@ -59,6 +59,10 @@ public:
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 
@@ -19,7 +19,7 @@ class AffectorFCN : public ProceduralRule<'AFCN'>, public AffectorProceduralRule
 
 public:
 	AffectorFCN() {
-
+		affectorType = AffectorProceduralRule::FLORA;
 	}
 
 	void parseFromIffStream(engine::util::IffStream* iffStream) {
@@ -52,6 +52,25 @@ public:
 
 		iffStream->closeChunk('DATA');
 	}
+
+	void process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j) {
+		// chunks keep no flora, leave the value the other affectors share alone
+		if (transformValue == 0 || chunk != NULL)
+			return;
+
+		if (flag == 0)
+			baseValue = (float)familyId;
+		else if (baseValue == familyId)
+			baseValue = 0;
+	}
+
+	bool isEnabled() {
+		return informationHeader.isEnabled();
+	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 #endif /* AFFECTORFCN_H_ */
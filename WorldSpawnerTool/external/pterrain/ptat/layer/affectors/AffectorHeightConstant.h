@@ -82,6 +82,41 @@ public:
 		}
 	}
 
+	void processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator) {
+		switch (operationType) {
+		case 1:
+			for (int k = 0; k < count; ++k) {
+				if (transformValue[k] != 0)
+					baseValue[k] = transformValue[k] * height + baseValue[k];
+			}
+			break;
+		case 2:
+			for (int k = 0; k < count; ++k) {
+				if (transformValue[k] != 0)
+					baseValue[k] = baseValue[k] - transformValue[k] * height;
+			}
+			break;
+		case 3:
+			for (int k = 0; k < count; ++k) {
+				if (transformValue[k] != 0)
+					baseValue[k] = baseValue[k] + (baseValue[k] * height - baseValue[k]) * transformValue[k];
+			}
+			break;
+		case 4:
+			for (int k = 0; k < count; ++k) {
+				if (transformValue[k] != 0)
+					baseValue[k] = 0;
+			}
+			break;
+		default:
+			for (int k = 0; k < count; ++k) {
+				if (transformValue[k] != 0)
+					baseValue[k] = (1.0 - transformValue[k]) * baseValue[k] + transformValue[k] * height;
+			}
+			break;
+		}
+	}
+
 	inline float getHeight() {
 		return height;
 	}
@@ -89,6 +124,10 @@ public:
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 
@@ -9,6 +9,10 @@
 #include "AffectorHeightFractal.h"
 #include "../../TerrainGenerator.h"
 
+void AffectorHeightFractal::executeRule(TerrainGenerator* terrainGenerator) {
+	mfrc = terrainGenerator->getMfrc(fractalId);
+}
+
 void AffectorHeightFractal::process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j) {
 	if (transformValue == 0)
 		return;
@@ -16,17 +20,20 @@ void AffectorHeightFractal::process(float x, float y, float transformValue, floa
 	if (chunk != NULL)
 		baseValue = chunk->getHeight(i, j);
 
-	if (mfrc == NULL) {
-		mfrc = terrainGenerator->getMfrc(fractalId);
+	// resolved in executeRule, never written here so chunks can be generated in parallel
+	MapFractal* fractal = mfrc;
 
-		if (mfrc == NULL) {
+	if (fractal == NULL) {
+		fractal = terrainGenerator->getMfrc(fractalId);
+
+		if (fractal == NULL) {
 			System::out << "error out of bounds fractal id for affector " << informationHeader.getDescription() << endl;
 
 			return;
 		}
 	}
 
-	float noiseResult = mfrc->getNoise(x, y, 0, 0) * height;
+	float noiseResult = fractal->getNoise(x, y, 0, 0) * height;
 
 	//System::out << "noiseResult " << noiseResult << " height:" << height << endl;
 
@@ -56,6 +63,57 @@ void AffectorHeightFractal::process(float x, float y, float transformValue, floa
 		chunk->setHeight(i, j, baseValue);
 }
 
+void AffectorHeightFractal::processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator) {
+	MapFractal* fractal = mfrc;
+
+	if (fractal == NULL) {
+		fractal = terrainGenerator->getMfrc(fractalId);
+
+		if (fractal == NULL) {
+			System::out << "error out of bounds fractal id for affector " << informationHeader.getDescription() << endl;
+
+			return;
+		}
+	}
+
+	const int blockSize = 64;
+	float noise[blockSize];
+
+	for (int k = 0; k < count; ++k) {
+		int block = k % blockSize;
+
+		if (block == 0)
+			fractal->getNoise(x + k, y + k, count - k < blockSize ? count - k : blockSize, noise);
+
+		float transform = transformValue[k];
+
+		if (transform == 0)
+			continue;
+
+		float noiseResult = noise[block] * height;
+		float base = baseValue[k];
+
+		switch (operationType) {
+		case 1:
+			base = base + noiseResult * transform;
+			break;
+		case 2:
+			base = base - noiseResult * transform;
+			break;
+		case 3:
+			base = base + (noiseResult * base - base) * transform;
+			break;
+		case 4:
+			break;
+		default:
+			base = base + (noiseResult - base) * transform;
+			break;
+		}
+
+		baseValue[k] = base;
+	}
+}
+
 void AffectorHeightFractal::parseFromIffStream(engine::util::IffStream* iffStream) {
 	uint32 version = iffStream->getNextFormType();
 
@@ -25,7 +25,10 @@ public:
 		affectorType = HEIGHTFRACTAL;
 	}
 
+	void executeRule(TerrainGenerator* terrainGenerator);
+
 	void process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j);
+	void processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator);
 
 	void parseFromIffStream(engine::util::IffStream* iffStream);
 	void parseFromIffStream(engine::util::IffStream* iffStream, Version<'0003'>);
@@ -41,6 +44,10 @@ public:
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 
@@ -82,6 +82,10 @@ public:
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 #endif /* AFFECTORHEIGHTTERRACE_H_ */
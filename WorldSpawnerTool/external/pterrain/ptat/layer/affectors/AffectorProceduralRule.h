@@ -29,16 +29,34 @@ public:
 	const static int ENVIRONMENT = 0x200;
 	const static int SHADER = 0x400;
 	const static int COLOR = 0x800;
+	const static int FLORA = 0x1000;
 	const static int ALL = 0xFFFFFFFF;
 
 	virtual ~AffectorProceduralRule() {
 
 	}
 
+	/**
+	 * Called once after loading, before any process() call. Lookups that would otherwise
+	 * be done lazily belong here so process() stays read only and safe to call from several threads.
+	 */
+	virtual void executeRule(TerrainGenerator* terrainGenerator) {
+
+	}
+
 	virtual void process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j) {
 
 	}
 
+	/**
+	 * Applies the affector to count samples at once, same results as calling process() on each.
+	 * Affectors override this to hoist their setup out of the per sample loop.
+	 */
+	virtual void processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator) {
+		for (int k = 0; k < count; ++k)
+			process(x[k], y[k], transformValue[k], baseValue[k], terrainGenerator, NULL, 0, 0);
+	}
+
 	inline bool isHeightTypeAffector() {
 		return affectorType & HEIGHTTYPE;
 	}
@@ -55,6 +73,13 @@ public:
 		return false;
 	}
 
+	/**
+	 * The name from the information header, for reports.
+	 */
+	virtual String getDescription() {
+		return "";
+	}
+
 };
 
 #endif /* AFFECTORPROCEDURALRULE_H_ */
@@ -12,20 +12,11 @@
 #include "../Road.h"
 #include "../Hdta.h"
 
-#include "AffectorProceduralRule.h"
-
-class Point2D  {
-public:
-	float x, y;
-
-	inline float getX() {
-		return x;
-	}
+#include "../Point2D.h"
+#include "../PolylineSegments.h"
 
-	inline float getY() {
-		return y;
-	}
-};
+#include "AffectorProceduralRule.h"
+#include "../../ProceduralTerrainAppearance.h"
 
 
 class AffectorRiver : public ProceduralRule<'ARIV'>, public AffectorProceduralRule {
@@ -50,9 +41,15 @@ class AffectorRiver : public ProceduralRule<'ARIV'>, public AffectorProceduralRu
 
 	String var15;
 
+	// the height data when there is some, the positions otherwise
+	PolylineSegments bed;
+	bool hasHeights;
+
 public:
 	AffectorRiver() {
+		affectorType = HEIGHTTYPE;
 
+		hasHeights = false;
 	}
 
 	~AffectorRiver() {
@@ -125,6 +122,82 @@ public:
 		iffStream->closeChunk('DATA');
 
 		iffStream->closeForm('DATA');
+
+		if (var6 > 1)
+			var6 = 1;
+		else if (var6 < 0)
+			var6 = 0;
+
+		hasHeights = addHeights(&bed, road.getSegments()) + addHeights(&bed, hdta.getSegments()) > 0;
+
+		if (!hasHeights)
+			bed.add(&positions);
+
+		bed.build(var2 * 0.5f);
+	}
+
+	/**
+	 * Digs the trench along the bed, below the height data or below the
+	 * terrain when there is none. The fields are read after AffectorRoad's
+	 * layout: var2 as the width, var5 and var6 as the feathering type and
+	 * amount, var7 as the depth.
+	 */
+	void process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j) {
+		if (transformValue == 0)
+			return;
+
+		float halfWidth = var2 * 0.5f;
+		double limit = (double) halfWidth * halfWidth;
+
+		float height = 0;
+		double distanceSquared = bed.getDistanceSquared(x, y, limit, &height);
+
+		if (distanceSquared >= limit)
+			return;
+
+		if (chunk != NULL)
+			baseValue = chunk->getHeight(i, j);
+
+		float target = (hasHeights ? height : baseValue) - var7;
+
+		baseValue += (target - baseValue) * getStrength(distanceSquared, halfWidth, var6, var5) * transformValue;
+
+		if (chunk != NULL)
+			chunk->setHeight(i, j, baseValue);
+	}
+
+	/**
+	 * How much a line of the given half width shapes a point distanceSquared
+	 * from its middle: 1 out to (1 - featheringAmount) * halfWidth, falling
+	 * to 0 at halfWidth along featheringType.
+	 */
+	static float getStrength(double distanceSquared, float halfWidth, float featheringAmount, int featheringType) {
+		double inner = (1.0 - featheringAmount) * halfWidth;
+
+		if (distanceSquared < inner * inner)
+			return 1.0;
+
+		float result = 1.0 - (sqrt(distanceSquared) - inner) / (halfWidth - inner);
+
+		return ProceduralTerrainAppearance::calculateFeathering(result, featheringType);
+	}
+
+	/**
+	 * Adds every segment with its heights, returns how many there were.
+	 */
+	static int addHeights(PolylineSegments* lines, Vector<Segment*>* segments) {
+		for (int i = 0; i < segments->size(); ++i)
+			lines->add(segments->get(i)->getPositions());
+
+		return segments->size();
+	}
+
+	bool isEnabled() {
+		return informationHeader.isEnabled();
+	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
 	}
 };
 
@@ -29,9 +29,12 @@ class AffectorRoad : public ProceduralRule<'AROA'>, public AffectorProceduralRul
 	int var6;
 	float var7;
 
+	// the height data along the road, empty when it has none
+	PolylineSegments surface;
+
 public:
 	AffectorRoad() {
-
+		affectorType = HEIGHTTYPE;
 	}
 
 	~AffectorRoad() {
@@ -97,6 +100,50 @@ public:
 		iffStream->closeChunk('DATA');
 
 		iffStream->closeForm('DATA');
+
+		if (featheringAmount > 1)
+			featheringAmount = 1;
+		else if (featheringAmount < 0)
+			featheringAmount = 0;
+
+		AffectorRiver::addHeights(&surface, road.getSegments());
+		AffectorRiver::addHeights(&surface, hdta.getSegments());
+
+		surface.build(var2 * 0.5f);
+	}
+
+	/**
+	 * Levels the terrain to the height data across width, feathered at the
+	 * edges. A road without height data leaves the terrain alone.
+	 */
+	void process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j) {
+		if (transformValue == 0)
+			return;
+
+		float halfWidth = var2 * 0.5f;
+		double limit = (double) halfWidth * halfWidth;
+
+		float height = 0;
+		double distanceSquared = surface.getDistanceSquared(x, y, limit, &height);
+
+		if (distanceSquared >= limit)
+			return;
+
+		if (chunk != NULL)
+			baseValue = chunk->getHeight(i, j);
+
+		baseValue += (height - baseValue) * AffectorRiver::getStrength(distanceSquared, halfWidth, featheringAmount, featheringType) * transformValue;
+
+		if (chunk != NULL)
+			chunk->setHeight(i, j, baseValue);
+	}
+
+	bool isEnabled() {
+		return informationHeader.isEnabled();
+	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
 	}
 };
 
@@ -64,6 +64,10 @@ public:
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 #endif /* AFFECTORSHADERCONSTANT_H_ */
@@ -36,6 +36,22 @@ public:
 		return 0;
 	}
 
+	/**
+	 * Evaluates count samples at once, result[k] is process(x[k], y[k]).
+	 */
+	virtual void processSamples(const float* x, const float* y, int count, float* result) {
+		for (int k = 0; k < count; ++k)
+			result[k] = process(x[k], y[k]);
+	}
+
+	/**
+	 * Axis aligned box outside of which process() is always 0. Returns false
+	 * when the boundary can't tell, callers must then assume it covers everything.
+	 */
+	virtual bool getBounds(float& minX, float& minY, float& maxX, float& maxY) {
+		return false;
+	}
+
 	inline int getFeatheringType() {
 		return featheringType;
 	}
@@ -44,6 +60,13 @@ public:
 		return false;
 	}
 
+	/**
+	 * The name from the information header, for reports.
+	 */
+	virtual String getDescription() {
+		return "";
+	}
+
 };
 
 
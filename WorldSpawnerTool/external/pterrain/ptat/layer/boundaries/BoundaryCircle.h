@@ -84,9 +84,22 @@ public:
 		return result;
 	}
 
+	bool getBounds(float& minX, float& minY, float& maxX, float& maxY) {
+		minX = centerX - radius;
+		minY = centerY - radius;
+		maxX = centerX + radius;
+		maxY = centerY + radius;
+
+		return true;
+	}
+
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 
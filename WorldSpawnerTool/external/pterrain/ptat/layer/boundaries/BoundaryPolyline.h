@@ -12,6 +12,7 @@
 #include "../ProceduralRule.h"
 #include "../affectors/AffectorRiver.h"
 #include "Boundary.h"
+#include "../PolylineSegments.h"
 
 class BoundaryPolyline : public ProceduralRule<'BPLN'>,  public Boundary {
 	Vector<Point2D*> points;
@@ -19,6 +20,9 @@ class BoundaryPolyline : public ProceduralRule<'BPLN'>,  public Boundary {
 
 	float minX, minY, maxX, maxY;
 
+	// the lines, indexed for process() queries up to lineWidth away
+	PolylineSegments segments;
+
 public:
 	BoundaryPolyline() {
 		//ruleType = BOUNDARYPOLYLINE;
@@ -27,7 +31,7 @@ public:
 		minY = 800000000;
 
 		maxX = -80000000;
-		minX = -80000000;
+		maxY = -80000000;
 	}
 
 	~BoundaryPolyline() {
@@ -97,6 +101,10 @@ public:
 		maxX = maxX + lineWidth;
 		minY = minY - lineWidth;
 		maxY = maxY + lineWidth;
+
+		segments.clear();
+		segments.add(&points);
+		segments.build(lineWidth);
 	}
 
 	float process(float x, float y) {
@@ -109,51 +117,12 @@ public:
 		if ( y > maxY )
 			return 0.0;
 
-		double v16 = lineWidth * lineWidth;
-		double v21 = 0;
+		double v31 = lineWidth * lineWidth;
 
-		double v31 = v16;
-		double v20, v19;
+		double v16 = segments.getDistanceSquared(x, y, v31);
 
 		double result = 0;
 
-		for (int i = 0; i < points.size(); ++i) {
-			Point2D* point = points.get(i);
-
-			v20 = y - point->y;
-			v19 = v20 * v20 + (x - point->x) * (x - point->x);
-			if ( v19 < v16 ) {
-				v21 = v19;
-				v16 = v21;
-			}
-		}
-
-		double v33, v35, v36, v26, v27, v25, v24, v28;
-
-		for (int i = 0; i < points.size() - 1; ++i) {
-			const Point2D* point = points.get(i);
-			const Point2D* point2 = points.get(i + 1);
-
-			v35 = point2->x - point->x;
-			v24 = point2->y - point->y;
-			v33 = v24;
-			v36 = ((y -  point->y) * v33 + (x - point->x) * v35) / (v24 * v24 + v35 * v35);
-
-			if ( v36 >= 0.0 ) {
-				if ( v36 <= 1.0 ) {
-					v26 = x - (v35 * v36 + point->x);
-					v27 = y - (v33 * v36 +  point->y);
-					v25 = v27 * v27 + v26 * v26;
-
-					if ( v25 < v16 ) {
-						v28 = v25;
-						v16 = v28;
-					}
-				}
-			}
-
-		}
-
 		if ( v16 >= v31 )
 			return 0.0;
 
@@ -167,9 +136,22 @@ public:
 		return result;
 	}
 
+	bool getBounds(float& minX, float& minY, float& maxX, float& maxY) {
+		minX = this->minX;
+		minY = this->minY;
+		maxX = this->maxX;
+		maxY = this->maxY;
+
+		return true;
+	}
+
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 
@@ -231,10 +231,23 @@ public:
 		initialize();
 	}
 
+	bool getBounds(float& minX, float& minY, float& maxX, float& maxY) {
+		minX = x0;
+		minY = y0;
+		maxX = x1;
+		maxY = y1;
+
+		return true;
+	}
+
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
 
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
+
 	float getX0() {
 		return x0;
 	}
@@ -0,0 +1,337 @@
+/*
+ * PolygonEdges.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef POLYGONEDGES_H_
+#define POLYGONEDGES_H_
+
+#include "engine/engine.h"
+#include "../Point2D.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POLYGON_SIMD_WIDTH 4
+#else
+#define POLYGON_SIMD_WIDTH 1
+#endif
+
+#include <limits>
+
+/**
+ * Per edge coefficients of a closed polygon, computed once and laid out as
+ * structure of arrays so the point queries run over them four edges at a
+ * time. Arrays are padded to a multiple of four with NaN edges, which fail
+ * every comparison and so never count.
+ *
+ * Edge i goes from vertex i - 1 (the last vertex for i = 0) to vertex i.
+ */
+class PolygonEdges {
+	int count;
+	int paddedCount;
+
+	float* buffer;
+
+	// vertex i and the one before it
+	float* pointX;
+	float* pointY;
+	float* lastX;
+	float* lastY;
+
+	// lastX - pointX and lastY - pointY
+	float* deltaX;
+	float* deltaY;
+
+	// 1 / (deltaX^2 + deltaY^2), in double as the distances are
+	double* inverseLengthSquared;
+
+	// containsPoint edges run from vertex i to i + 1, with x sorted and
+	// the line y = slope * x + intercept
+	float* lineMinX;
+	float* lineMaxX;
+	float* nextY;
+	float* slope;
+	float* intercept;
+
+public:
+	PolygonEdges() {
+		count = 0;
+		paddedCount = 0;
+		buffer = NULL;
+		inverseLengthSquared = NULL;
+	}
+
+	~PolygonEdges() {
+		delete [] buffer;
+		delete [] inverseLengthSquared;
+	}
+
+	void build(Vector<Point2D*>* vertices);
+
+	inline int size() {
+		return count;
+	}
+
+	/**
+	 * Even-odd test used by BoundaryPolygon::process, counting edges whose
+	 * crossing with the horizontal through y lies right of x.
+	 */
+	bool isInside(float x, float y);
+
+	/**
+	 * Smallest squared distance from the point to any vertex or edge,
+	 * starting from limit, same arithmetic as the original scalar loops.
+	 */
+	double getDistanceSquared(float x, float y, double limit);
+
+	/**
+	 * Crossing test used for water, BoundaryPolygon::containsPoint.
+	 */
+	bool containsPoint(float x, float y);
+};
+
+inline void PolygonEdges::build(Vector<Point2D*>* vertices) {
+	delete [] buffer;
+	delete [] inverseLengthSquared;
+
+	count = vertices->size();
+	paddedCount = (count + 3) & ~3;
+
+	const int arrays = 11;
+
+	buffer = new float[arrays * paddedCount];
+	inverseLengthSquared = new double[paddedCount];
+
+	float* arraysStart[arrays];
+
+	for (int i = 0; i < arrays; ++i)
+		arraysStart[i] = buffer + i * paddedCount;
+
+	pointX = arraysStart[0];
+	pointY = arraysStart[1];
+	lastX = arraysStart[2];
+	lastY = arraysStart[3];
+	deltaX = arraysStart[4];
+	deltaY = arraysStart[5];
+	lineMinX = arraysStart[6];
+	lineMaxX = arraysStart[7];
+	nextY = arraysStart[8];
+	slope = arraysStart[9];
+	intercept = arraysStart[10];
+
+	float nan = std::numeric_limits<float>::quiet_NaN();
+
+	for (int i = 0; i < arrays * paddedCount; ++i)
+		buffer[i] = nan;
+
+	for (int i = 0; i < paddedCount; ++i)
+		inverseLengthSquared[i] = nan;
+
+	for (int i = 0; i < count; ++i) {
+		Point2D* point = vertices->get(i);
+		Point2D* lastPoint = vertices->get(i == 0 ? count - 1 : i - 1);
+		Point2D* nextPoint = vertices->get(i + 1 == count ? 0 : i + 1);
+
+		pointX[i] = point->x;
+		pointY[i] = point->y;
+		lastX[i] = lastPoint->x;
+		lastY[i] = lastPoint->y;
+		deltaX[i] = lastPoint->x - point->x;
+		deltaY[i] = lastPoint->y - point->y;
+
+		double dx = deltaX[i], dy = deltaY[i];
+		inverseLengthSquared[i] = 1.0 / (dy * dy + dx * dx);
+
+		if (point->x < nextPoint->x) {
+			lineMinX[i] = point->x;
+			lineMaxX[i] = nextPoint->x;
+		} else {
+			lineMinX[i] = nextPoint->x;
+			lineMaxX[i] = point->x;
+		}
+
+		static const float eps = 0.000001;
+
+		float lineDeltaX = nextPoint->x - point->x;
+		float lineDeltaY = nextPoint->y - point->y;
+
+		if (fabs(lineDeltaX) < eps)
+			slope[i] = std::numeric_limits<float>::infinity();
+		else
+			slope[i] = lineDeltaY / lineDeltaX;
+
+		intercept[i] = point->y - slope[i] * point->x;
+		nextY[i] = nextPoint->y;
+	}
+}
+
+inline bool PolygonEdges::isInside(float x, float y) {
+	int crossings = 0;
+	int i = 0;
+
+#if POLYGON_SIMD_WIDTH == 4
+	__m128 vx = _mm_set1_ps(x), vy = _mm_set1_ps(y);
+	__m128i sum = _mm_setzero_si128();
+
+	for (; i < paddedCount; i += 4) {
+		__m128 py = _mm_loadu_ps(pointY + i);
+		__m128 qy = _mm_loadu_ps(lastY + i);
+
+		// (py <= y && y < qy) || (qy <= y && y < py)
+		__m128 straddles = _mm_or_ps(_mm_and_ps(_mm_cmple_ps(py, vy), _mm_cmplt_ps(vy, qy)),
+				_mm_and_ps(_mm_cmple_ps(qy, vy), _mm_cmplt_ps(vy, py)));
+
+		// (y - py) * dx / dy + px > x, the division only matters where straddling
+		__m128 crossing = _mm_add_ps(_mm_div_ps(_mm_mul_ps(_mm_sub_ps(vy, py), _mm_loadu_ps(deltaX + i)), _mm_loadu_ps(deltaY + i)), _mm_loadu_ps(pointX + i));
+
+		__m128 counts = _mm_and_ps(straddles, _mm_cmpgt_ps(crossing, vx));
+		sum = _mm_sub_epi32(sum, _mm_castps_si128(counts));
+	}
+
+	int lanes[4];
+	_mm_storeu_si128((__m128i*) lanes, sum);
+	crossings = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#else
+	for (; i < count; ++i) {
+		if ((pointY[i] <= y && y < lastY[i]) || (lastY[i] <= y && y < pointY[i])) {
+			if ((y - pointY[i]) * deltaX[i] / deltaY[i] + pointX[i] > x)
+				++crossings;
+		}
+	}
+#endif
+
+	return crossings & 1;
+}
+
+inline double PolygonEdges::getDistanceSquared(float x, float y, double limit) {
+	double best = limit;
+	int i = 0;
+
+#if POLYGON_SIMD_WIDTH == 4
+	__m128 vx = _mm_set1_ps(x), vy = _mm_set1_ps(y);
+	__m128d bestLow = _mm_set1_pd(limit), bestHigh = bestLow;
+
+	__m128d dx = _mm_set1_pd(x), dy = _mm_set1_pd(y);
+	__m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0);
+
+	for (; i < paddedCount; i += 4) {
+		// vertices: (y - py)^2 in double plus (x - px)^2 in float
+		__m128 ey = _mm_sub_ps(vy, _mm_loadu_ps(pointY + i));
+		__m128 ex = _mm_sub_ps(vx, _mm_loadu_ps(pointX + i));
+		__m128 ex2 = _mm_mul_ps(ex, ex);
+
+		__m128d eyLow = _mm_cvtps_pd(ey), eyHigh = _mm_cvtps_pd(_mm_movehl_ps(ey, ey));
+
+		__m128d vertexLow = _mm_add_pd(_mm_mul_pd(eyLow, eyLow), _mm_cvtps_pd(ex2));
+		__m128d vertexHigh = _mm_add_pd(_mm_mul_pd(eyHigh, eyHigh), _mm_cvtps_pd(_mm_movehl_ps(ex2, ex2)));
+
+		__m128d closer = _mm_cmplt_pd(vertexLow, bestLow);
+		bestLow = _mm_or_pd(_mm_and_pd(closer, vertexLow), _mm_andnot_pd(closer, bestLow));
+		closer = _mm_cmplt_pd(vertexHigh, bestHigh);
+		bestHigh = _mm_or_pd(_mm_and_pd(closer, vertexHigh), _mm_andnot_pd(closer, bestHigh));
+
+		// edges: projection parameter t of the point on last -> point
+		__m128 wx = _mm_sub_ps(vx, _mm_loadu_ps(lastX + i));
+		__m128 wy = _mm_sub_ps(vy, _mm_loadu_ps(lastY + i));
+		__m128 qx = _mm_loadu_ps(lastX + i), qy = _mm_loadu_ps(lastY + i);
+		__m128 ax = _mm_loadu_ps(deltaX + i), ay = _mm_loadu_ps(deltaY + i);
+
+		for (int half = 0; half < 2; ++half) {
+			__m128d wxd = _mm_cvtps_pd(wx), wyd = _mm_cvtps_pd(wy);
+			__m128d qxd = _mm_cvtps_pd(qx), qyd = _mm_cvtps_pd(qy);
+
+			// point - last, the negated deltas
+			__m128d sx = _mm_sub_pd(zero, _mm_cvtps_pd(ax)), sy = _mm_sub_pd(zero, _mm_cvtps_pd(ay));
+
+			__m128d t = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(wxd, sx), _mm_mul_pd(wyd, sy)), _mm_loadu_pd(inverseLengthSquared + i + half * 2));
+
+			__m128d cx = _mm_sub_pd(dx, _mm_add_pd(_mm_mul_pd(sx, t), qxd));
+			__m128d cy = _mm_sub_pd(dy, _mm_add_pd(_mm_mul_pd(sy, t), qyd));
+			__m128d distance = _mm_add_pd(_mm_mul_pd(cy, cy), _mm_mul_pd(cx, cx));
+
+			__m128d inside = _mm_and_pd(_mm_cmpge_pd(t, zero), _mm_cmple_pd(t, one));
+			__m128d& bestHalf = half == 0 ? bestLow : bestHigh;
+
+			closer = _mm_and_pd(inside, _mm_cmplt_pd(distance, bestHalf));
+			bestHalf = _mm_or_pd(_mm_and_pd(closer, distance), _mm_andnot_pd(closer, bestHalf));
+
+			wx = _mm_movehl_ps(wx, wx);
+			wy = _mm_movehl_ps(wy, wy);
+			qx = _mm_movehl_ps(qx, qx);
+			qy = _mm_movehl_ps(qy, qy);
+			ax = _mm_movehl_ps(ax, ax);
+			ay = _mm_movehl_ps(ay, ay);
+		}
+	}
+
+	double lanes[4];
+	_mm_storeu_pd(lanes, bestLow);
+	_mm_storeu_pd(lanes + 2, bestHigh);
+
+	for (int k = 0; k < 4; ++k) {
+		if (lanes[k] < best)
+			best = lanes[k];
+	}
+#else
+	for (; i < count; ++i) {
+		double ey = y - pointY[i];
+		double distance = ey * ey + (x - pointX[i]) * (x - pointX[i]);
+
+		if (distance < best)
+			best = distance;
+	}
+
+	for (i = 0; i < count; ++i) {
+		double sx = -deltaX[i], sy = -deltaY[i];
+		double t = ((x - lastX[i]) * sx + (y - lastY[i]) * sy) * inverseLengthSquared[i];
+
+		if (t >= 0.0 && t <= 1.0) {
+			double cx = x - (sx * t + lastX[i]);
+			double cy = y - (sy * t + lastY[i]);
+			double distance = cy * cy + cx * cx;
+
+			if (distance < best)
+				best = distance;
+		}
+	}
+#endif
+
+	return best;
+}
+
+inline bool PolygonEdges::containsPoint(float x, float y) {
+	int crossings = 0;
+	int i = 0;
+
+#if POLYGON_SIMD_WIDTH == 4
+	__m128 vx = _mm_set1_ps(x), vy = _mm_set1_ps(y);
+	__m128i sum = _mm_setzero_si128();
+
+	for (; i < paddedCount; i += 4) {
+		// x > x1 && x <= x2 && (y < yi || y <= yi+1)
+		__m128 possible = _mm_and_ps(_mm_cmpgt_ps(vx, _mm_loadu_ps(lineMinX + i)), _mm_cmple_ps(vx, _mm_loadu_ps(lineMaxX + i)));
+		possible = _mm_and_ps(possible, _mm_or_ps(_mm_cmplt_ps(vy, _mm_loadu_ps(pointY + i)), _mm_cmple_ps(vy, _mm_loadu_ps(nextY + i))));
+
+		__m128 lineY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(slope + i), vx), _mm_loadu_ps(intercept + i));
+
+		__m128 counts = _mm_and_ps(possible, _mm_cmple_ps(vy, lineY));
+		sum = _mm_sub_epi32(sum, _mm_castps_si128(counts));
+	}
+
+	int lanes[4];
+	_mm_storeu_si128((__m128i*) lanes, sum);
+	crossings = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#else
+	for (; i < count; ++i) {
+		if (x > lineMinX[i] && x <= lineMaxX[i] && (y < pointY[i] || y <= nextY[i])) {
+			if (y <= slope[i] * x + intercept[i])
+				++crossings;
+		}
+	}
+#endif
+
+	return crossings % 2 == 1;
+}
+
+#endif /* POLYGONEDGES_H_ */
@@ -10,11 +10,18 @@
 #include "../../TerrainGenerator.h"
 
 
+void FilterFractal::executeRule(TerrainGenerator* terrainGenerator) {
+	mfrc = terrainGenerator->getMfrc(fractalId);
+}
+
 float FilterFractal::process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j) {
-	if (mfrc == NULL) {
-		mfrc = terrainGenerator->getMfrc(fractalId);
+	// resolved in executeRule, never written here so chunks can be generated in parallel
+	MapFractal* fractal = mfrc;
+
+	if (fractal == NULL) {
+		fractal = terrainGenerator->getMfrc(fractalId);
 
-		if (mfrc == NULL) {
+		if (fractal == NULL) {
 			System::out << "error out of bounds fractal id for filter " << informationHeader.getDescription() << endl;
 
 			return 1;
@@ -24,7 +31,34 @@ float FilterFractal::process(float x, float y, float transformValue, float& base
 	if (chunk != NULL) 
 		baseValue = chunk->getHeight(i, j);
 
-	float noiseResult = mfrc->getNoise(x, y, 0, 0) * var6;
+	float noiseResult = fractal->getNoise(x, y, 0, 0) * var6;
+
+	return filterNoise(noiseResult);
+}
+
+void FilterFractal::processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator, float* result) {
+	MapFractal* fractal = mfrc;
+
+	if (fractal == NULL) {
+		fractal = terrainGenerator->getMfrc(fractalId);
+
+		if (fractal == NULL) {
+			System::out << "error out of bounds fractal id for filter " << informationHeader.getDescription() << endl;
+
+			for (int k = 0; k < count; ++k)
+				result[k] = 1;
+
+			return;
+		}
+	}
+
+	fractal->getNoise(x, y, count, result);
+
+	for (int k = 0; k < count; ++k)
+		result[k] = filterNoise(result[k] * var6);
+}
+
+float FilterFractal::filterNoise(float noiseResult) {
 	float result = 0;
 
 	if (noiseResult > min && noiseResult < max) {
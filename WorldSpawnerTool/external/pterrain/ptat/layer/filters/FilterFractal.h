@@ -32,11 +32,24 @@ public:
 	void parseFromIffStream(engine::util::IffStream* iffStream);
 	void parseFromIffStream(engine::util::IffStream* iffStream, Version<'0005'>);
 
+	void executeRule(TerrainGenerator* terrainGenerator);
+
 	float process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j);
+	void processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator, float* result);
+
+	float filterNoise(float noiseResult);
+
+	bool usesBaseValue() {
+		return false;
+	}
 
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 #endif /* FILTERFRACTAL_H_ */
@@ -33,14 +33,43 @@ public:
 
 	}
 
+	/**
+	 * Called once after loading, see AffectorProceduralRule::executeRule.
+	 */
+	virtual void executeRule(TerrainGenerator* terrainGenerator) {
+
+	}
+
 	virtual float process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator,  TerrainChunk* chunk, int i, int j) {
 		return 0;
 	}
 
+	/**
+	 * Filters count samples at once, result[k] is what process() returns for sample k.
+	 */
+	virtual void processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator, float* result) {
+		for (int k = 0; k < count; ++k)
+			result[k] = process(x[k], y[k], transformValue[k], baseValue[k], terrainGenerator, NULL, 0, 0);
+	}
+
+	/**
+	 * False when process() ignores baseValue, so one result serves every query type at a point.
+	 */
+	virtual bool usesBaseValue() {
+		return true;
+	}
+
 	virtual bool isEnabled() {
 		return false;
 	}
 
+	/**
+	 * The name from the information header, for reports.
+	 */
+	virtual String getDescription() {
+		return "";
+	}
+
 	inline int getFeatheringType() {
 		return featheringType;
 	}
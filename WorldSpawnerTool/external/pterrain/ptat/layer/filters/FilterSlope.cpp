@@ -0,0 +1,47 @@
+/*
+ * FilterSlope.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "FilterSlope.h"
+
+#include "../../TerrainGenerator.h"
+#include "../../TerrainChunk.h"
+#include "../../ProceduralTerrainAppearance.h"
+
+float FilterSlope::process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j) {
+	if (chunk != NULL) {
+		baseValue = chunk->getHeight(i, j);
+
+		if (chunk->hasNormals())
+			return processNormal(chunk->getNormalZ(i, j));
+	}
+
+	ProceduralTerrainAppearance* terrain = terrainGenerator->getTerrain();
+
+	// the heights the slope is measured on pass no slope filter
+	if (terrain->isSamplingSlopes())
+		return 0;
+
+	float normalZ;
+	terrain->getSlopeNormals(&x, &y, 1, &normalZ);
+
+	return processNormal(normalZ);
+}
+
+void FilterSlope::processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator, float* result) {
+	ProceduralTerrainAppearance* terrain = terrainGenerator->getTerrain();
+
+	if (terrain->isSamplingSlopes()) {
+		for (int k = 0; k < count; ++k)
+			result[k] = 0;
+
+		return;
+	}
+
+	terrain->getSlopeNormals(x, y, count, result);
+
+	for (int k = 0; k < count; ++k)
+		result[k] = processNormal(result[k]);
+}
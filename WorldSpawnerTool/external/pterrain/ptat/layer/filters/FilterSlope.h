@@ -98,23 +98,36 @@ public:
 		iffStream->closeChunk('DATA');
 	}
 
-	float process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j) {
-		float result;
+	/**
+	 * The slope is the one ProceduralTerrainAppearance::getSlopeNormals gives,
+	 * read from the chunk normals when generating chunks.
+	 */
+	float process(float x, float y, float transformValue, float& baseValue, TerrainGenerator* terrainGenerator, TerrainChunk* chunk, int i, int j);
+
+	void processSamples(const float* x, const float* y, const float* transformValue, float* baseValue, int count, TerrainGenerator* terrainGenerator, float* result);
 
-		if (chunk != NULL) 
-			baseValue = chunk->getHeight(i, j);
+	bool usesBaseValue() {
+		return false;
+	}
 
-		if (baseValue > min && baseValue < max) {
+	/**
+	 * Result for a sample whose normal has normalZ as its vertical component,
+	 * see TerrainNormals.
+	 */
+	float processNormal(float normalZ) {
+		float result;
+
+		if (normalZ > min && normalZ < max) {
 			float v7 = max - min * featheringAmount * 0.5;
 
-			if (min + v7 <= baseValue) {
-				if (max - v7 >= baseValue) {
+			if (min + v7 <= normalZ) {
+				if (max - v7 >= normalZ) {
 					result = 1.0;
 				} else {
-					result = (max - baseValue) / v7;
+					result = (max - normalZ) / v7;
 				}
 			} else
-				result = (baseValue - min) / v7;
+				result = (normalZ - min) / v7;
 		} else
 			result = 0;
 
@@ -124,6 +137,10 @@ public:
 	bool isEnabled() {
 		return informationHeader.isEnabled();
 	}
+
+	String getDescription() {
+		return informationHeader.getDescription();
+	}
 };
 
 #endif /* FILTERSLOPE_H_ */
@@ -48,6 +48,7 @@
 #include <osgDB/ReaderWriter>
 #include <boost/shared_ptr.hpp>
 #include <treLib/treArchive.hpp>
+#include <meshLib/meshCache.hpp>
 
 #ifndef SWGREPOSITORY_HPP
 #define SWGREPOSITORY_HPP
@@ -96,15 +97,30 @@ public:
   treArchive* getTreArchive() {
 	  return &archive;
   }
+
+  /// Keep flattened MESH/SKMG geometry in directory so models open
+  /// without reparsing. An empty directory turns the cache off.
+  void setMeshCacheDirectory( const std::string &directory );
+
+  ml::meshCache* getMeshCache() {
+	  return meshCache.get();
+  }
   
 
 protected:
+  osg::ref_ptr< osg::Node >
+  loadCachedMesh( const std::string &filename,
+		  boost::shared_ptr<std::istream> iffFile,
+		  const std::string &type );
+  osg::ref_ptr< osg::Node > buildMesh( const ml::meshCache::entry &cached );
+
   osgDB::ReaderWriter *ddsPlugin;
   treArchive archive;
   std::map< std::string, osg::ref_ptr< osg::Texture2D > > textureMap;
   std::map< std::string, osg::ref_ptr< osg::Material > > materialMap;
   std::map< std::string, osg::ref_ptr< osg::StateSet > > stateMap;
   std::map< std::string, osg::ref_ptr< osg::Node > > nodeMap;
+  boost::shared_ptr< ml::meshCache > meshCache;
   OpenThreads::ReentrantMutex mutex;
 
 };
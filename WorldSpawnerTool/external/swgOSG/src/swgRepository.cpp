@@ -135,7 +135,7 @@ swgRepository::loadFile( const std::string &filename )
     }
   else if( "MESH" == type )
     {
-      newNode = loadMSH( iffFile );
+      newNode = loadCachedMesh( filename, iffFile, type );
     }
   else if( "MLOD" == type )
     {
@@ -171,7 +171,7 @@ swgRepository::loadFile( const std::string &filename )
     }
   else if( "SKMG" == type )
     {
-      newNode = loadSKMG( iffFile );
+      newNode = loadCachedMesh( filename, iffFile, type );
     }
   else if( "SKTM" == type )
     {
@@ -616,6 +616,145 @@ swgRepository::loadMSH( boost::shared_ptr<std::istream> meshFile )
 	return geode;
 }
 
+void swgRepository::setMeshCacheDirectory( const std::string &directory )
+{
+  if( directory.empty() )
+    {
+      meshCache.reset();
+    }
+  else
+    {
+      meshCache.reset( new ml::meshCache( directory ) );
+    }
+}
+
+osg::ref_ptr< osg::Node >
+swgRepository::loadCachedMesh( const std::string &filename,
+			       boost::shared_ptr<std::istream> iffFile,
+			       const std::string &type )
+{
+  std::vector<unsigned char> md5sum;
+  if( NULL == meshCache.get() || !archive.getFileMD5( filename, md5sum ) )
+    {
+      if( "MESH" == type )
+	{
+	  return loadMSH( iffFile );
+	}
+      return loadSKMG( iffFile );
+    }
+
+  boost::shared_ptr<ml::meshCache::entry> cached =
+    meshCache->find( filename, md5sum );
+
+  if( NULL == cached.get() )
+    {
+      std::cout << "Adding to mesh cache: " << filename << std::endl;
+
+      if( "MESH" == type )
+	{
+	  ml::msh swgMesh;
+	  if( 0 == swgMesh.readMSH( *iffFile ) )
+	    {
+	      return NULL;
+	    }
+	  cached = meshCache->store( filename, md5sum, swgMesh );
+	}
+      else
+	{
+	  ml::skmg swgSKMG;
+	  if( 0 == swgSKMG.readSKMG( *iffFile ) )
+	    {
+	      return NULL;
+	    }
+	  cached = meshCache->store( filename, md5sum, swgSKMG );
+	}
+    }
+
+  // Cache could not be written, build from the stream as usual.
+  if( NULL == cached.get() )
+    {
+      iffFile->clear();
+      iffFile->seekg( 0, std::ios_base::beg );
+      if( "MESH" == type )
+	{
+	  return loadMSH( iffFile );
+	}
+      return loadSKMG( iffFile );
+    }
+
+  return buildMesh( *cached );
+}
+
+osg::ref_ptr< osg::Node >
+swgRepository::buildMesh( const ml::meshCache::entry &cached )
+{
+  osg::ref_ptr< osg::Geode > geode( new osg::Geode() );
+
+  for( unsigned int s = 0; s < cached.getNumSurfaces(); ++s )
+    {
+      const ml::meshCache::surface &surf = cached.getSurface( s );
+      unsigned int numVertices = surf.getNumVertices();
+
+      // Cached arrays have the same layout as the osg vectors, so each
+      // array is a single copy out of the mapped file.
+      osg::Vec3Array* vertices =
+	new osg::Vec3Array( numVertices,
+			    reinterpret_cast<const osg::Vec3*>( surf.getPositions() ) );
+      osg::Vec3Array* normals =
+	new osg::Vec3Array( numVertices,
+			    reinterpret_cast<const osg::Vec3*>( surf.getNormals() ) );
+      osg::Vec4Array* colors =
+	new osg::Vec4Array( numVertices,
+			    reinterpret_cast<const osg::Vec4*>( surf.getColors() ) );
+
+      osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+
+      geometry->setVertexArray( vertices );
+
+      geometry->setColorArray( colors );
+      geometry->setColorBinding( osg::Geometry::BIND_PER_VERTEX );
+
+      geometry->setNormalArray( normals );
+      geometry->setNormalBinding( osg::Geometry::BIND_PER_VERTEX );
+
+      for( unsigned int j = 0; j < surf.getNumTexCoordSets(); ++j )
+	{
+	  geometry->setTexCoordArray(
+	    j,
+	    new osg::Vec2Array( numVertices,
+				reinterpret_cast<const osg::Vec2*>( surf.getTexCoords( j ) ) )
+	    );
+	}
+
+      osg::ElementBufferObject* ebo = new osg::ElementBufferObject;
+      for( unsigned int j = 0; j < surf.getNumGroups(); ++j )
+	{
+	  if( 0 == surf.getNumIndices( j ) )
+	    {
+	      continue;
+	    }
+
+	  osg::DrawElementsUInt* drawElements =
+	    new osg::DrawElementsUInt( osg::PrimitiveSet::TRIANGLES,
+				       surf.getNumIndices( j ),
+				       surf.getIndices( j ) );
+	  drawElements->setElementBufferObject( ebo );
+	  geometry->addPrimitiveSet( drawElements );
+	}
+
+      geometry->setStateSet( loadShader( surf.getShader() ) );
+
+      osg::VertexBufferObject *vbo = new osg::VertexBufferObject;
+      vertices->setVertexBufferObject( vbo );
+
+      geometry->setUseVertexBufferObjects( ( NULL != vbo ) );
+
+      geode->addDrawable( geometry.get() );
+    }
+
+  return geode;
+}
+
 osg::ref_ptr< osg::Node >
 swgRepository::loadSKMG( boost::shared_ptr<std::istream> meshFile )
 {
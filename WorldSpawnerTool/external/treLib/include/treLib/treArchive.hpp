@@ -28,6 +28,7 @@
 #include <sstream>
 #include <string>
 #include <list>
+#include <vector>
 #include <treLib/treClass.hpp>
 #include <OpenThreads/Mutex>
 
@@ -58,6 +59,11 @@ public:
 
   std::stringstream *getFileStream( const std::string &filename );
 
+  /// Get the MD5 sum of a file. Uses the sum stored in the TRE when
+  /// present, otherwise it is calculated from the file data.
+  bool getFileMD5( const std::string &filename,
+		   std::vector<unsigned char> &md5sum );
+
 protected:
 	std::list< treClass* > treList;
 	OpenThreads::Mutex mutex;
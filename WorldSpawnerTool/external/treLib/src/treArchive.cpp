@@ -26,6 +26,7 @@
 #include <treLib/treArchive.hpp>
 #include <OpenThreads/ScopedLock>
 #include <OpenThreads/Mutex>
+#include <md5.h>
 
 treArchive::treArchive()
 {
@@ -197,3 +198,53 @@ std::stringstream *treArchive::getFileStream( const std::string &filename )
 
   return NULL;
 }
+
+bool treArchive::getFileMD5( const std::string &filename,
+			     std::vector<unsigned char> &md5sum )
+{
+  md5sum.clear();
+
+  std::string correctedFilename( filename );
+  fixSlash( correctedFilename  );
+
+  unsigned int index = 0;
+  for( std::list<treClass *>::const_iterator i = treList.begin();
+       i != treList.end();
+       ++i 
+       )
+    {
+      if( (*i)->getFileRecordIndex( correctedFilename, index ) == true )
+	{
+	  // Older TRE versions do not carry a MD5 block.
+	  const std::vector<unsigned char> &recordSum =
+	    (*i)->getFileRecordList()[index].getMD5sum();
+	  if( 16 == recordSum.size() )
+	    {
+	      md5sum = recordSum;
+	      return true;
+	    }
+
+	  std::stringstream *data = NULL;
+	  {
+	    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex);
+	    data = (*i)->saveRecordAsStream( index );
+	  }
+
+	  if( NULL == data )
+	    {
+	      return false;
+	    }
+
+	  std::string buffer( data->str() );
+	  delete data;
+
+	  unsigned char sum[16];
+	  md5_csum( (unsigned char *)buffer.data(), buffer.size(), sum );
+	  md5sum.assign( sum, sum + 16 );
+
+	  return true;
+	}
+    }
+
+  return false;
+}